@@ -1,1053 +1,2284 @@
-/*
- * DallasTemperature.c
- *
- *  Created on: Dec 24, 2020
- *      Author: tabur
- */
-#include "DallasTemperature.h"
-
-// OneWire commands
-#define STARTCONVO      0x44  // Tells device to take a temperature reading and put it on the scratchpad
-#define COPYSCRATCH     0x48  // Copy scratchpad to EEPROM
-#define READSCRATCH     0xBE  // Read from scratchpad
-#define WRITESCRATCH    0x4E  // Write to scratchpad
-#define RECALLSCRATCH   0xB8  // Recall from EEPROM to scratchpad
-#define READPOWERSUPPLY 0xB4  // Determine if device needs parasite power
-#define ALARMSEARCH     0xEC  // Query bus for devices with an alarm condition
-
-// Scratchpad locations
-#define TEMP_LSB        0
-#define TEMP_MSB        1
-#define HIGH_ALARM_TEMP 2
-#define LOW_ALARM_TEMP  3
-#define CONFIGURATION   4
-#define INTERNAL_BYTE   5
-#define COUNT_REMAIN    6
-#define COUNT_PER_C     7
-#define SCRATCHPAD_CRC  8
-
-// DSROM FIELDS
-#define DSROM_FAMILY    0
-#define DSROM_CRC       7
-
-// Device resolution
-#define TEMP_9_BIT  0x1F //  9 bit
-#define TEMP_10_BIT 0x3F // 10 bit
-#define TEMP_11_BIT 0x5F // 11 bit
-#define TEMP_12_BIT 0x7F // 12 bit
-
-#define MAX_CONVERSION_TIMEOUT		750
-
-static void BlockTillConversionComplete(DallasTemperature_HandleTypeDef* dt, uint8_t bitResolution);
-static void ActivateExternalPullup(DallasTemperature_HandleTypeDef* dt);
-static void DeactivateExternalPullup(DallasTemperature_HandleTypeDef* dt);
-//static bool IsAllZeros(const uint8_t * const scratchPad, const size_t length);
-
-// Continue to check if the IC has responded with a temperature
-static void BlockTillConversionComplete(DallasTemperature_HandleTypeDef* dt, uint8_t bitResolution)
-{
-	int delms = DT_MillisToWaitForConversion(bitResolution);
-
-	if (dt->checkForConversion && !dt->parasite)
-	{
-		unsigned long now = HAL_GetTick();
-		while (!DT_IsConversionComplete(dt) && (HAL_GetTick() - delms < now))
-		{
-			__NOP();
-		}
-	}
-	else
-	{
-		ActivateExternalPullup(dt);
-		HAL_Delay(delms);
-		DeactivateExternalPullup(dt);
-	}
-}
-
-static void ActivateExternalPullup(DallasTemperature_HandleTypeDef* dt)
-{
-	if(dt->useExternalPullup)
-	{
-		HAL_GPIO_WritePin(GPIOC, GPIO_PIN_10, GPIO_PIN_RESET);
-	}
-}
-
-static void DeactivateExternalPullup(DallasTemperature_HandleTypeDef* dt)
-{
-	if(dt->useExternalPullup)
-	{
-		HAL_GPIO_WritePin(GPIOC, GPIO_PIN_10, GPIO_PIN_SET);
-	}
-}
-
-// Returns true if all bytes of scratchPad are '\0'
-//static bool IsAllZeros(const uint8_t * const scratchPad, const size_t length)
-//{
-//	for (size_t i = 0; i < length; i++)
-//	{
-//		if (scratchPad[i] != 0)
-//		{
-//			return false;
-//		}
-//	}
-//
-//	return true;
-//}
-
-void DT_SetPullupPin(DallasTemperature_HandleTypeDef* dt, GPIO_TypeDef* port, uint32_t pin)
-{
-	dt->useExternalPullup = true;
-
-	/*Configure GPIO pin : ONE_WIRE_Pin */
-	GPIO_InitTypeDef GPIO_InitStruct = {0};
-	GPIO_InitStruct.Pin = pin;
-	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-	GPIO_InitStruct.Pull = GPIO_PULLUP;
-	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_MEDIUM;
-	HAL_GPIO_Init(port, &GPIO_InitStruct);
-
-	DeactivateExternalPullup(dt);
-}
-
-void DT_SetOneWire(DallasTemperature_HandleTypeDef* dt, OneWire_HandleTypeDef* ow)
-{
-	dt->ow 					= ow;
-	dt->devices 			= 0;
-	dt->ds18Count 			= 0;
-	dt->parasite 			= false;
-	dt->bitResolution 		= 9;
-	dt->waitForConversion 	= true;
-	dt->checkForConversion 	= true;
-	dt->autoSaveScratchPad 	= true;
-	dt->useExternalPullup 	= false;
-}
-
-void DT_Begin(DallasTemperature_HandleTypeDef* dt)
-{
-	AllDeviceAddress deviceAddress;
-
-	OW_ResetSearch(dt->ow);
-	dt->devices = 0; 	// Reset the number of devices when we enumerate wire devices
-	dt->ds18Count = 0; 	// Reset number of DS18xxx Family devices
-
-	dt->devices = OW_Search(dt->ow, deviceAddress, ONEWIRE_MAX_DEVICES);
-
-	for(uint8_t i = 0; i < dt->devices; i++)
-	{
-		if (DT_ValidAddress(&deviceAddress[i * 8]))
-		{
-
-			if (!dt->parasite && DT_ReadPowerSupply(dt, &deviceAddress[i * 8]))
-				dt->parasite = true;
-
-			dt->bitResolution = max(dt->bitResolution, DT_GetResolution(dt, &deviceAddress[i * 8]));
-
-			if (DT_ValidFamily(&deviceAddress[i * 8]))
-			{
-				dt->ds18Count++;
-			}
-		}
-	}
-}
-
-// returns the number of devices found on the bus
-uint8_t DT_GetDeviceCount(DallasTemperature_HandleTypeDef* dt)
-{
-	return dt->devices;
-}
-
-uint8_t DT_GetDS18Count(DallasTemperature_HandleTypeDef* dt)
-{
-	return dt->ds18Count;
-}
-
-// returns true if address is valid
-bool DT_ValidAddress(const uint8_t* deviceAddress)
-{
-	return (OW_Crc8(deviceAddress, 7) == deviceAddress[7]);
-}
-
-bool DT_ValidFamily(const uint8_t* deviceAddress)
-{
-	switch (deviceAddress[DSROM_FAMILY])
-	{
-	case DS18S20MODEL:
-	case DS18B20MODEL:
-	case DS1822MODEL:
-	case DS1825MODEL:
-	case DS28EA00MODEL:
-		return true;
-	default:
-		return false;
-	}
-}
-
-// finds an address at a given index on the bus
-// returns true if the device was found
-bool DT_GetAddress(DallasTemperature_HandleTypeDef* dt, uint8_t* currentDeviceAddress, uint8_t index)
-{
-	AllDeviceAddress deviceAddress;
-
-	uint8_t depth = 0;
-
-	depth = OW_Search(dt->ow, deviceAddress, ONEWIRE_MAX_DEVICES);
-
-	if(index < depth && DT_ValidAddress(&deviceAddress[index * 8]))
-	{
-		memcpy(currentDeviceAddress, &deviceAddress[index * 8], 8);
-		return true;
-	}
-
-	return false;
-}
-
-// attempt to determine if the device at the given address is connected to the bus
-bool DT_IsConnected(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	ScratchPad scratchPad;
-	return DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad);
-}
-
-// attempt to determine if the device at the given address is connected to the bus
-// also allows for updating the read scratchpad
-bool DT_IsConnected_ScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t* scratchPad)
-{
-	bool b = DT_ReadScratchPad(dt, deviceAddress, scratchPad);
-	return (b /*&& IsAllZeros(scratchPad, 8)*/ && (OW_Crc8(scratchPad, 8) == scratchPad[SCRATCHPAD_CRC]));
-}
-
-bool DT_ReadScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t* scratchPad)
-{
-	// send the reset command and fail fast
-	int b = OW_Reset(dt->ow);
-
-	if (b == 0)
-		return false;
-
-	uint8_t query[19]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, READSCRATCH, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
-	memcpy(&query[1], deviceAddress, 8);
-
-	// Read all registers in a simple loop
-	// byte 0: temperature LSB
-	// byte 1: temperature MSB
-	// byte 2: high alarm temp
-	// byte 3: low alarm temp
-	// byte 4: DS18S20: store for crc
-	//         DS18B20 & DS1822: configuration register
-	// byte 5: internal use & crc
-	// byte 6: DS18S20: COUNT_REMAIN
-	//         DS18B20 & DS1822: store for crc
-	// byte 7: DS18S20: COUNT_PER_C
-	//         DS18B20 & DS1822: store for crc
-	// byte 8: SCRATCHPAD_CRC
-
-	b = OW_Send(dt->ow, query, 19, scratchPad, 9, 10);
-
-	return (b == OW_OK);
-}
-
-void DT_WriteScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, const uint8_t* scratchPad)
-{
-	uint8_t query[13]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, WRITESCRATCH, scratchPad[HIGH_ALARM_TEMP], scratchPad[LOW_ALARM_TEMP], scratchPad[CONFIGURATION]};
-	memcpy(&query[1], deviceAddress, 8);
-
-	// DS1820 and DS18S20 have no configuration register
-	if (deviceAddress[DSROM_FAMILY] != DS18S20MODEL)
-	{
-		OW_Send(dt->ow, query, 13, NULL, 0, OW_NO_READ);
-	}
-	else
-	{
-		OW_Send(dt->ow, query, 12, NULL, 0, OW_NO_READ);
-	}
-
-	if (dt->autoSaveScratchPad)
-	{
-		DT_SaveScratchPad(dt, deviceAddress);
-	}
-	else
-	{
-		OW_Reset(dt->ow);
-	}
-}
-
-// returns true if parasite mode is used (2 wire)
-// returns false if normal mode is used (3 wire)
-// if no address is given (or nullptr) it checks if any device on the bus
-// uses parasite mode.
-bool DT_ReadPowerSupply(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	uint8_t parasiteMode = 0;
-
-	OW_Reset(dt->ow);
-
-	uint8_t query[11]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, READPOWERSUPPLY, 0xFF};
-
-	if (deviceAddress == NULL)
-	{
-	  query[0] = 0xCC;
-	  query[1] = READPOWERSUPPLY;
-	  OW_Send(dt->ow, query, 3, &parasiteMode, 1, 2);
-	}
-	else
-	{
-	  query[0] = 0x55;
-	  memcpy(&query[1], deviceAddress, 8);
-	  OW_Send(dt->ow, query, 10, &parasiteMode, 1, 10);
-	}
-
-	OW_Reset(dt->ow);
-
-	if (parasiteMode == 0)
-	{
-		return true;
-	}
-	else
-	{
-		return false;
-	}
-}
-
-// set resolution of all devices to 9, 10, 11, or 12 bits
-// if new resolution is out of range, it is constrained.
-void DT_SetAllResolution(DallasTemperature_HandleTypeDef* dt, uint8_t newResolution)
-{
-	dt->bitResolution = constrain(newResolution, 9, 12);
-	CurrentDeviceAddress deviceAddress;
-
-	for (int i = 0; i < dt->devices; i++)
-	{
-		DT_GetAddress(dt, deviceAddress, i);
-		DT_SetResolution(dt, deviceAddress, dt->bitResolution, true);
-	}
-}
-
-// set resolution of a device to 9, 10, 11, or 12 bits
-// if new resolution is out of range, 9 bits is used.
-bool DT_SetResolution(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t newResolution, bool skipGlobalBitResolutionCalculation)
-{
-	// ensure same behavior as setResolution(uint8_t newResolution)
-	newResolution = constrain(newResolution, 9, 12);
-
-	// return when stored value == new value
-	if (DT_GetResolution(dt, deviceAddress) == newResolution)
-		return true;
-
-	ScratchPad scratchPad;
-
-	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
-	{
-		// DS1820 and DS18S20 have no resolution configuration register
-		if (deviceAddress[DSROM_FAMILY] != DS18S20MODEL)
-		{
-			switch (newResolution)
-			{
-			case 12:
-				scratchPad[CONFIGURATION] = TEMP_12_BIT;
-				break;
-			case 11:
-				scratchPad[CONFIGURATION] = TEMP_11_BIT;
-				break;
-			case 10:
-				scratchPad[CONFIGURATION] = TEMP_10_BIT;
-				break;
-			case 9:
-			default:
-				scratchPad[CONFIGURATION] = TEMP_9_BIT;
-				break;
-			}
-
-			DT_WriteScratchPad(dt, deviceAddress, scratchPad);
-
-			// without calculation we can always set it to max
-			dt->bitResolution = max(dt->bitResolution, newResolution);
-
-			if (!skipGlobalBitResolutionCalculation && (dt->bitResolution > newResolution))
-			{
-				dt->bitResolution = newResolution;
-
-				CurrentDeviceAddress deviceAddr;
-
-				for (int i = 0; i < dt->devices; i++)
-				{
-					DT_GetAddress(dt, deviceAddr, i);
-					dt->bitResolution = max(dt->bitResolution, DT_GetResolution(dt, deviceAddr));
-				}
-			}
-		}
-		return true;  // new value set
-	}
-	return false;
-}
-
-// returns the global resolution
-uint8_t DT_GetAllResolution(DallasTemperature_HandleTypeDef* dt)
-{
-	return dt->bitResolution;
-}
-
-// returns the current resolution of the device, 9-12
-// returns 0 if device not found
-uint8_t DT_GetResolution(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	// DS1820 and DS18S20 have no resolution configuration register
-	if (deviceAddress[0] == DS18S20MODEL)
-		return 12;
-
-	ScratchPad scratchPad;
-	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
-	{
-		switch (scratchPad[CONFIGURATION])
-		{
-		case TEMP_12_BIT:
-			return 12;
-
-		case TEMP_11_BIT:
-			return 11;
-
-		case TEMP_10_BIT:
-			return 10;
-
-		case TEMP_9_BIT:
-			return 9;
-		}
-	}
-	return 0;
-}
-
-// sets the value of the waitForConversion flag
-// TRUE : function requestTemperature() etc returns when conversion is ready
-// FALSE: function requestTemperature() etc returns immediately (USE WITH CARE!!)
-//        (1) programmer has to check if the needed delay has passed
-//        (2) but the application can do meaningful things in that time
-void DT_SetWaitForConversion(DallasTemperature_HandleTypeDef* dt, bool flag)
-{
-	dt->waitForConversion = flag;
-}
-
-// gets the value of the waitForConversion flag
-bool DT_GetWaitForConversion(DallasTemperature_HandleTypeDef* dt)
-{
-	return dt->waitForConversion;
-}
-
-// sets the value of the checkForConversion flag
-// TRUE : function requestTemperature() etc will 'listen' to an IC to determine whether a conversion is complete
-// FALSE: function requestTemperature() etc will wait a set time (worst case scenario) for a conversion to complete
-void DT_SetCheckForConversion(DallasTemperature_HandleTypeDef* dt, bool flag)
-{
-	dt->checkForConversion = flag;
-}
-
-// gets the value of the waitForConversion flag
-bool DT_GetCheckForConversion(DallasTemperature_HandleTypeDef* dt)
-{
-	return dt->checkForConversion;
-}
-
-bool DT_IsConversionComplete(DallasTemperature_HandleTypeDef* dt)
-{
-	uint8_t b;
-	OW_Send(dt->ow, (uint8_t *) OW_READ_SLOT, 0, &b, 1, 0);
-
-	return (b == 1);
-}
-
-// sends command for all devices on the bus to perform a temperature conversion
-void DT_RequestTemperatures(DallasTemperature_HandleTypeDef* dt)
-{
-	OW_Send(dt->ow, (uint8_t *) "\xcc\x44", 2, (uint8_t *) NULL, 0, OW_NO_READ);
-
-	// ASYNC mode?
-	if (!dt->waitForConversion)
-		return;
-
-	BlockTillConversionComplete(dt, dt->bitResolution);
-}
-
-// sends command for one device to perform a temperature by address
-// returns FALSE if device is disconnected
-// returns TRUE  otherwise
-bool DT_RequestTemperaturesByAddress(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	uint8_t bitResolution = DT_GetResolution(dt, deviceAddress);
-
-	if (bitResolution == 0)
-	{
-		return false; //Device disconnected
-	}
-
-	uint8_t query[10]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, STARTCONVO};
-	memcpy(&query[1], deviceAddress, 8);
-	OW_Send(dt->ow, query, 10, NULL, 0, OW_NO_READ);
-
-	// ASYNC mode?
-	if (!dt->waitForConversion)
-		return true;
-
-	BlockTillConversionComplete(dt, dt->bitResolution);
-
-	return true;
-}
-
-// sends command for one device to perform a temp conversion by index
-bool DT_RequestTemperaturesByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex)
-{
-	CurrentDeviceAddress deviceAddress;
-	DT_GetAddress(dt, deviceAddress, deviceIndex);
-
-	return DT_RequestTemperaturesByAddress(dt, deviceAddress);
-}
-
-// returns number of milliseconds to wait till conversion is complete (based on IC datasheet)
-int16_t DT_MillisToWaitForConversion(uint8_t bitResolution)
-{
-	switch (bitResolution)
-	{
-	case 9:
-		return 94;
-	case 10:
-		return 188;
-	case 11:
-		return 375;
-	default:
-		return 750;
-	}
-}
-
-// Sends command to one device to save values from scratchpad to EEPROM by index
-// Returns true if no errors were encountered, false indicates failure
-bool DT_SaveScratchPadByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex)
-{
-	CurrentDeviceAddress deviceAddress;
-  if (!DT_GetAddress(dt, deviceAddress, deviceIndex)) return false;
-
-  return DT_SaveScratchPad(dt, deviceAddress);
-}
-
-// Sends command to one or more devices to save values from scratchpad to EEPROM
-// If optional argument deviceAddress is omitted the command is send to all devices
-// Returns true if no errors were encountered, false indicates failure
-bool DT_SaveScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	uint8_t query[10]={0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-
-	if (OW_Reset(dt->ow) == 0)
-		return false;
-
-  if (deviceAddress == NULL)
-  {
-	  query[0] = 0xCC;
-	  query[1] = COPYSCRATCH;
-	  OW_Send(dt->ow, query, 2, NULL, 0, OW_NO_READ);
-  }
-  else
-  {
-	  query[0] = 0x55;
-	  memcpy(&query[1], deviceAddress, 8);
-	  query[9] = COPYSCRATCH;
-	  OW_Send(dt->ow, query, 10, NULL, 0, OW_NO_READ);
-  }
-
-  // Specification: NV Write Cycle Time is typically 2ms, max 10ms
-  // Waiting 20ms to allow for sensors that take longer in practice
-  if (!dt->parasite)
-  {
-    HAL_Delay(20);
-  }
-  else
-  {
-
-	ActivateExternalPullup(dt);
-    HAL_Delay(20);
-    DeactivateExternalPullup(dt);
-  }
-
-  return OW_Reset(dt->ow) == 1;
-}
-
-// Sends command to one device to recall values from EEPROM to scratchpad by index
-// Returns true if no errors were encountered, false indicates failure
-bool DT_RecallScratchPadByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex)
-{
-  CurrentDeviceAddress deviceAddress;
-  if (!DT_GetAddress(dt, deviceAddress, deviceIndex)) return false;
-
-  return DT_RecallScratchPad(dt, deviceAddress);
-}
-
-// Sends command to one or more devices to recall values from EEPROM to scratchpad
-// If optional argument deviceAddress is omitted the command is send to all devices
-// Returns true if no errors were encountered, false indicates failure
-bool DT_RecallScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	uint8_t query[10]={0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-
-	if (OW_Reset(dt->ow) == 0)
-		return false;
-
-	if (deviceAddress == NULL)
-	{
-	  query[0] = 0xCC;
-	  query[1] = RECALLSCRATCH;
-	  OW_Send(dt->ow, query, 2, NULL, 0, OW_NO_READ);
-	}
-	else
-	{
-	  query[0] = 0x55;
-	  memcpy(&query[1], deviceAddress, 8);
-	  query[9] = RECALLSCRATCH;
-	  OW_Send(dt->ow, query, 10, NULL, 0, OW_NO_READ);
-	}
-
-	// Specification: Strong pullup only needed when writing to EEPROM (and temp conversion)
-	uint32_t start = HAL_GetTick();
-
-	while (dt->ow->huart->gState == HAL_UART_STATE_TIMEOUT)
-	{
-		// Datasheet doesn't specify typical/max duration, testing reveals typically within 1ms
-		if (HAL_GetTick() - start > 20) return false;
-		__NOP();
-	}
-
-	return OW_Reset(dt->ow) == 1;
-}
-
-// Sets the autoSaveScratchPad flag
-void DT_SetAutoSaveScratchPad(DallasTemperature_HandleTypeDef* dt, bool flag)
-{
-  dt->autoSaveScratchPad = flag;
-}
-
-// Gets the autoSaveScratchPad flag
-bool DT_GetAutoSaveScratchPad(DallasTemperature_HandleTypeDef* dt)
-{
-  return dt->autoSaveScratchPad;
-}
-
-// Fetch temperature for device index
-float DT_GetTempCByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex)
-{
-	CurrentDeviceAddress deviceAddress;
-
-	if (!DT_GetAddress(dt, deviceAddress, deviceIndex))
-	{
-		return DEVICE_DISCONNECTED_C;
-	}
-
-	return DT_GetTempC(dt, (uint8_t*) deviceAddress);
-}
-
-// Fetch temperature for device index
-float DT_GetTempFByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex)
-{
-	CurrentDeviceAddress deviceAddress;
-
-	if (!DT_GetAddress(dt, deviceAddress, deviceIndex))
-	{
-		return DEVICE_DISCONNECTED_F;
-	}
-
-	return DT_GetTempF(dt, (uint8_t*) deviceAddress);
-}
-
-// reads scratchpad and returns fixed-point temperature, scaling factor 2^-7
-int16_t DT_CalculateTemperature(const uint8_t* deviceAddress, uint8_t* scratchPad)
-{
-	int16_t fpTemperature = (((int16_t) scratchPad[TEMP_MSB]) << 11) | (((int16_t) scratchPad[TEMP_LSB]) << 3);
-
-	/*
-	 DS1820 and DS18S20 have a 9-bit temperature register.
-
-	 Resolutions greater than 9-bit can be calculated using the data from
-	 the temperature, and COUNT REMAIN and COUNT PER °C registers in the
-	 scratchpad.  The resolution of the calculation depends on the model.
-
-	 While the COUNT PER °C register is hard-wired to 16 (10h) in a
-	 DS18S20, it changes with temperature in DS1820.
-
-	 After reading the scratchpad, the TEMP_READ value is obtained by
-	 truncating the 0.5°C bit (bit 0) from the temperature data. The
-	 extended resolution temperature can then be calculated using the
-	 following equation:
-
-	 COUNT_PER_C - COUNT_REMAIN
-	 TEMPERATURE = TEMP_READ - 0.25 + --------------------------
-	 COUNT_PER_C
-
-	 Hagai Shatz simplified this to integer arithmetic for a 12 bits
-	 value for a DS18S20, and James Cameron added legacy DS1820 support.
-
-	 See - http://myarduinotoy.blogspot.co.uk/2013/02/12bit-result-from-ds18s20.html
-	 */
-
-	if (deviceAddress[0] == DS18S20MODEL)
-	{
-		fpTemperature = ((fpTemperature & 0xfff0) << 3) - 16 + (((scratchPad[COUNT_PER_C] - scratchPad[COUNT_REMAIN]) << 7) / scratchPad[COUNT_PER_C]);
-	}
-
-	return fpTemperature;
-}
-
-// returns temperature in 1/128 degrees C or DEVICE_DISCONNECTED_RAW if the
-// device's scratch pad cannot be read successfully.
-// the numeric value of DEVICE_DISCONNECTED_RAW is defined in
-// DallasTemperature.h. It is a large negative number outside the
-// operating range of the device
-int16_t DT_GetTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	ScratchPad scratchPad;
-	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
-		return DT_CalculateTemperature(deviceAddress, scratchPad);
-	return DEVICE_DISCONNECTED_RAW;
-}
-
-// returns temperature in degrees C or DEVICE_DISCONNECTED_C if the
-// device's scratch pad cannot be read successfully.
-// the numeric value of DEVICE_DISCONNECTED_C is defined in
-// DallasTemperature.h. It is a large negative number outside the
-// operating range of the device
-float DT_GetTempC(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	return DT_RawToCelsius(DT_GetTemp(dt, deviceAddress));
-}
-
-// returns temperature in degrees F or DEVICE_DISCONNECTED_F if the
-// device's scratch pad cannot be read successfully.
-// the numeric value of DEVICE_DISCONNECTED_F is defined in
-// DallasTemperature.h. It is a large negative number outside the
-// operating range of the device
-float DT_GetTempF(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	return DT_RawToFahrenheit(DT_GetTemp(dt, deviceAddress));
-}
-
-// returns true if the bus requires parasite power
-bool DT_IsParasitePowerMode(DallasTemperature_HandleTypeDef* dt)
-{
-	return dt->parasite;
-}
-
-// IF alarm is not used one can store a 16 bit int of userdata in the alarm
-// registers. E.g. an ID of the sensor.
-// See github issue #29
-
-// note if device is not connected it will fail writing the data.
-void DT_SetUserData(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, int16_t data)
-{
-	// return when stored value == new value
-	if (DT_GetUserData(dt, deviceAddress) == data)
-		return;
-
-	ScratchPad scratchPad;
-	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
-	{
-		scratchPad[HIGH_ALARM_TEMP] = data >> 8;
-		scratchPad[LOW_ALARM_TEMP] = data & 255;
-		DT_WriteScratchPad(dt, deviceAddress, scratchPad);
-	}
-}
-
-int16_t DT_GetUserData(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	int16_t data = 0;
-	ScratchPad scratchPad;
-	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
-	{
-		data = scratchPad[HIGH_ALARM_TEMP] << 8;
-		data += scratchPad[LOW_ALARM_TEMP];
-	}
-	return data;
-}
-
-// note If address cannot be found no error will be reported.
-int16_t DT_GetUserDataByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex)
-{
-	CurrentDeviceAddress deviceAddress;
-	DT_GetAddress(dt, deviceAddress, deviceIndex);
-	return DT_GetUserData(dt, (uint8_t*) deviceAddress);
-}
-
-void DT_SetUserDataByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex, int16_t data)
-{
-	CurrentDeviceAddress deviceAddress;
-	DT_GetAddress(dt, deviceAddress, deviceIndex);
-	DT_SetUserData(dt, (uint8_t*) deviceAddress, data);
-}
-
-// Convert float Celsius to Fahrenheit
-float DT_ToFahrenheit(float celsius)
-{
-	return (celsius * 1.8) + 32;
-}
-
-// Convert float Fahrenheit to Celsius
-float DT_ToCelsius(float fahrenheit)
-{
-	return (fahrenheit - 32) * 0.555555556;
-}
-
-// convert from raw to Celsius
-float DT_RawToCelsius(int16_t raw)
-{
-	if (raw <= DEVICE_DISCONNECTED_RAW)
-		return DEVICE_DISCONNECTED_C;
-	// C = RAW/128
-	return (float) raw * 0.0078125;
-}
-
-// convert from raw to Fahrenheit
-float DT_RawToFahrenheit(int16_t raw)
-{
-	if (raw <= DEVICE_DISCONNECTED_RAW)
-		return DEVICE_DISCONNECTED_F;
-	// C = RAW/128
-	// F = (C*1.8)+32 = (RAW/128*1.8)+32 = (RAW*0.0140625)+32
-	return ((float) raw * 0.0140625) + 32;
-}
-
-#if REQUIRESALARMS
-/*
-
- ALARMS:
-
- TH and TL Register Format
-
- BIT 7 BIT 6 BIT 5 BIT 4 BIT 3 BIT 2 BIT 1 BIT 0
- S    2^6   2^5   2^4   2^3   2^2   2^1   2^0
-
- Only bits 11 through 4 of the temperature register are used
- in the TH and TL comparison since TH and TL are 8-bit
- registers. If the measured temperature is lower than or equal
- to TL or higher than or equal to TH, an alarm condition exists
- and an alarm flag is set inside the DS18B20. This flag is
- updated after every temperature measurement; therefore, if the
- alarm condition goes away, the flag will be turned off after
- the next temperature conversion.
-
- */
-
-// sets the high alarm temperature for a device in degrees Celsius
-// accepts a float, but the alarm resolution will ignore anything
-// after a decimal point.  valid range is -55C - 125C
-void DT_SetHighAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, int8_t celsius)
-{
-	// return when stored value == new value
-	if (DT_GetHighAlarmTemp(dt, deviceAddress) == celsius)
-		return;
-
-	// make sure the alarm temperature is within the device's range
-	if (celsius > 125)
-		celsius = 125;
-	else if (celsius < -55)
-		celsius = -55;
-
-	ScratchPad scratchPad;
-	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
-	{
-		scratchPad[HIGH_ALARM_TEMP] = (uint8_t) celsius;
-		DT_WriteScratchPad(dt, deviceAddress, scratchPad);
-	}
-}
-
-// sets the low alarm temperature for a device in degrees Celsius
-// accepts a float, but the alarm resolution will ignore anything
-// after a decimal point.  valid range is -55C - 125C
-void DT_SetLowAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, int8_t celsius)
-{
-	// return when stored value == new value
-	if (DT_GetLowAlarmTemp(dt, deviceAddress) == celsius)
-		return;
-
-	// make sure the alarm temperature is within the device's range
-	if (celsius > 125)
-		celsius = 125;
-	else if (celsius < -55)
-		celsius = -55;
-
-	ScratchPad scratchPad;
-	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
-	{
-		scratchPad[LOW_ALARM_TEMP] = (uint8_t) celsius;
-		DT_WriteScratchPad(dt, deviceAddress, scratchPad);
-	}
-}
-
-// returns a int8_t with the current high alarm temperature or
-// DEVICE_DISCONNECTED for an address
-int8_t DT_GetHighAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	ScratchPad scratchPad;
-	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
-		return (int8_t) scratchPad[HIGH_ALARM_TEMP];
-	return DEVICE_DISCONNECTED_C;
-}
-
-// returns a int8_t with the current low alarm temperature or
-// DEVICE_DISCONNECTED for an address
-int8_t DT_GetLowAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	ScratchPad scratchPad;
-	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
-		return (int8_t) scratchPad[LOW_ALARM_TEMP];
-	return DEVICE_DISCONNECTED_C;
-}
-
-// resets internal variables used for the alarm search
-void DT_ResetAlarmSearch(DallasTemperature_HandleTypeDef* dt)
-{
-	dt->alarmSearchJunction = -1;
-	dt->alarmSearchExhausted = 0;
-	for (uint8_t i = 0; i < 7; i++)
-	{
-		dt->alarmSearchAddress[i] = 0;
-	}
-}
-
-// This is a modified version of the OneWire::search method.
-//
-// Also added the OneWire search fix documented here:
-// http://www.arduino.cc/cgi-bin/yabb2/YaBB.pl?num=1238032295
-//
-// Perform an alarm search. If this function returns a '1' then it has
-// enumerated the next device and you may retrieve the ROM from the
-// OneWire::address variable. If there are no devices, no further
-// devices, or something horrible happens in the middle of the
-// enumeration then a 0 is returned.  If a new device is found then
-// its address is copied to newAddr.  Use
-// DallasTemperature::resetAlarmSearch() to start over.
-bool DT_AlarmSearch(DallasTemperature_HandleTypeDef* dt, uint8_t* newAddr)
-{
-//	uint8_t i;
-//	int8_t lastJunction = -1;
-//	uint8_t done = 1;
-
-	if (dt->alarmSearchExhausted)
-		return false;
-
-	if (!OW_Reset(dt->ow))
-		return false;
-/* TODO:
-	// send the alarm search command
-	_wire->write(0xEC, 0);
-
-	for (i = 0; i < 64; i++) {
-
-		uint8_t a = _wire->read_bit();
-		uint8_t nota = _wire->read_bit();
-		uint8_t ibyte = i / 8;
-		uint8_t ibit = 1 << (i & 7);
-
-		// I don't think this should happen, this means nothing responded, but maybe if
-		// something vanishes during the search it will come up.
-		if (a && nota)
-			return false;
-
-		if (!a && !nota) {
-			if (i == alarmSearchJunction) {
-				// this is our time to decide differently, we went zero last time, go one.
-				a = 1;
-				alarmSearchJunction = lastJunction;
-			} else if (i < alarmSearchJunction) {
-
-				// take whatever we took last time, look in address
-				if (alarmSearchAddress[ibyte] & ibit) {
-					a = 1;
-				} else {
-					// Only 0s count as pending junctions, we've already exhausted the 0 side of 1s
-					a = 0;
-					done = 0;
-					lastJunction = i;
-				}
-			} else {
-				// we are blazing new tree, take the 0
-				a = 0;
-				alarmSearchJunction = i;
-				done = 0;
-			}
-			// OneWire search fix
-			// See: http://www.arduino.cc/cgi-bin/yabb2/YaBB.pl?num=1238032295
-		}
-
-		if (a)
-			alarmSearchAddress[ibyte] |= ibit;
-		else
-			alarmSearchAddress[ibyte] &= ~ibit;
-
-		_wire->write_bit(a);
-	}
-
-	if (done)
-		alarmSearchExhausted = 1;
-	for (i = 0; i < 8; i++)
-		newAddr[i] = alarmSearchAddress[i];*/
-	return true;
-
-}
-
-// returns true if device address might have an alarm condition
-// (only an alarm search can verify this)
-bool DT_HasAlarmByAddress(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
-{
-	ScratchPad scratchPad;
-
-	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
-	{
-		int8_t temp = DT_CalculateTemperature(deviceAddress, scratchPad) >> 7;
-
-		// check low alarm
-		if (temp <= (int8_t) scratchPad[LOW_ALARM_TEMP])
-			return true;
-
-		// check high alarm
-		if (temp >= (int8_t) scratchPad[HIGH_ALARM_TEMP])
-			return true;
-	}
-
-	// no alarm
-	return false;
-
-}
-
-// returns true if any device is reporting an alarm condition on the bus
-bool DT_HasAlarm(DallasTemperature_HandleTypeDef* dt)
-{
-	CurrentDeviceAddress deviceAddress;
-	DT_ResetAlarmSearch(dt);
-	return DT_AlarmSearch(dt, deviceAddress);
-}
-
-// runs the alarm handler for all devices returned by alarmSearch()
-// unless there no _AlarmHandler exist.
-void DT_ProcessAlarms(DallasTemperature_HandleTypeDef* dt)
-{
-	if (!DT_HasAlarmHandler(dt))
-	{
-		return;
-	}
-
-	DT_ResetAlarmSearch(dt);
-	CurrentDeviceAddress alarmAddr;
-
-	while (DT_AlarmSearch(dt, alarmAddr))
-	{
-		if (DT_ValidAddress(alarmAddr))
-		{
-			dt->_AlarmHandler(alarmAddr);
-		}
-	}
-}
-
-// sets the alarm handler
-void DT_SetAlarmHandler(DallasTemperature_HandleTypeDef* dt, const AlarmHandler *handler)
-{
-	dt->_AlarmHandler = handler;
-}
-
-// checks if AlarmHandler has been set.
-bool DT_HasAlarmHandler(DallasTemperature_HandleTypeDef* dt)
-{
-  return dt->_AlarmHandler != NO_ALARM_HANDLER;
-}
-
-#endif
+/*
+ * DallasTemperature.c
+ *
+ *  Created on: Dec 24, 2020
+ *      Author: tabur
+ */
+#include "DallasTemperature.h"
+
+// OneWire commands
+#define STARTCONVO      0x44  // Tells device to take a temperature reading and put it on the scratchpad
+#define COPYSCRATCH     0x48  // Copy scratchpad to EEPROM
+#define READSCRATCH     0xBE  // Read from scratchpad
+#define WRITESCRATCH    0x4E  // Write to scratchpad
+#define RECALLSCRATCH   0xB8  // Recall from EEPROM to scratchpad
+#define READPOWERSUPPLY 0xB4  // Determine if device needs parasite power
+#define ALARMSEARCH     0xEC  // Query bus for devices with an alarm condition
+
+// Scratchpad locations
+#define TEMP_LSB        0
+#define TEMP_MSB        1
+#define HIGH_ALARM_TEMP 2
+#define LOW_ALARM_TEMP  3
+#define CONFIGURATION   4
+#define INTERNAL_BYTE   5
+#define COUNT_REMAIN    6
+#define COUNT_PER_C     7
+#define SCRATCHPAD_CRC  8
+
+// DSROM FIELDS
+#define DSROM_FAMILY    0
+#define DSROM_CRC       7
+
+// Device resolution
+#define TEMP_9_BIT  0x1F //  9 bit
+#define TEMP_10_BIT 0x3F // 10 bit
+#define TEMP_11_BIT 0x5F // 11 bit
+#define TEMP_12_BIT 0x7F // 12 bit
+
+#define MAX_CONVERSION_TIMEOUT		750
+
+static void BlockTillConversionComplete(DallasTemperature_HandleTypeDef* dt, uint8_t bitResolution);
+static void ActivateExternalPullup(DallasTemperature_HandleTypeDef* dt);
+static void DeactivateExternalPullup(DallasTemperature_HandleTypeDef* dt);
+static uint8_t ScratchPadStatus(const uint8_t* scratchPad, bool crcOk);
+static uint8_t ReadDeviceRaw(DallasTemperature_HandleTypeDef* dt, uint8_t* query, uint16_t deviceIndex, int16_t* raw, bool* present);
+static DallasTemperature_DeviceTypeDef* FindDevice(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+static uint8_t DeviceResolution(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex);
+static uint8_t TableResolution(DallasTemperature_HandleTypeDef* dt);
+static uint8_t ResolutionToConfig(uint8_t bitResolution);
+static uint8_t ConfigToResolution(uint8_t config);
+static bool SendScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, const uint8_t* scratchPad);
+static bool WriteScratchPadRam(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, const uint8_t* scratchPad);
+static void StoreConfig(DallasTemperature_DeviceTypeDef* device, const uint8_t* scratchPad);
+static bool ReadConfig(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t* scratchPad);
+static void HoldConfig(DallasTemperature_DeviceTypeDef* device, const uint8_t* scratchPad);
+static uint8_t SendAddressed(DallasTemperature_HandleTypeDef* dt, DallasTemperature_DeviceTypeDef* device, uint8_t* query, uint8_t cLen, uint8_t* data, uint8_t dLen, uint8_t readStart);
+static bool FastReadRaw(DallasTemperature_HandleTypeDef* dt, DallasTemperature_DeviceTypeDef* device, int16_t* raw);
+static void InitDevice(DallasTemperature_DeviceTypeDef* device);
+static void ProbeDevice(DallasTemperature_HandleTypeDef* dt, DallasTemperature_DeviceTypeDef* device);
+static bool SearchesBefore(const uint8_t* a, const uint8_t* b);
+static void InsertDevice(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex, const uint8_t* deviceAddress);
+static void RemoveDevice(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex);
+static void CountSensors(DallasTemperature_HandleTypeDef* dt);
+static bool FinishUpdate(DallasTemperature_HandleTypeDef* dt, bool complete, uint16_t* changes);
+static bool NextUpdatePass(DallasTemperature_HandleTypeDef* dt, uint16_t* changes);
+static uint8_t SearchPasses(DallasTemperature_HandleTypeDef* dt);
+static void StartSearchPass(DallasTemperature_HandleTypeDef* dt, uint8_t pass);
+#if REQUIRESALARMS
+static bool ReadChanged(DallasTemperature_HandleTypeDef* dt, uint8_t* query, DallasTemperature_DeviceTypeDef* device, bool* present);
+static void RestoreWindows(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+#endif
+
+// the families DT_ValidFamily accepts, in the order the search finds them,
+// so family by family searches still fill the table in search order
+static const uint8_t SensorFamilies[] = { DS1825MODEL, DS1822MODEL, DS28EA00MODEL, DS18B20MODEL, DS18S20MODEL };
+//static bool IsAllZeros(const uint8_t * const scratchPad, const size_t length);
+
+// Continue to check if the IC has responded with a temperature
+static void BlockTillConversionComplete(DallasTemperature_HandleTypeDef* dt, uint8_t bitResolution)
+{
+	int delms = DT_MillisToWaitForConversion(bitResolution);
+
+	if (dt->checkForConversion && !dt->parasite)
+	{
+		uint32_t start = HAL_GetTick();
+		uint16_t interval = DT_MillisBetweenConversionPolls(bitResolution);
+
+		while (!DT_IsConversionComplete(dt) && (HAL_GetTick() - start < (uint32_t) delms))
+		{
+			HAL_Delay(interval);
+		}
+	}
+	else
+	{
+		ActivateExternalPullup(dt);
+		HAL_Delay(delms);
+		DeactivateExternalPullup(dt);
+	}
+}
+
+static void ActivateExternalPullup(DallasTemperature_HandleTypeDef* dt)
+{
+	if(dt->useExternalPullup)
+	{
+		HAL_GPIO_WritePin(GPIOC, GPIO_PIN_10, GPIO_PIN_RESET);
+	}
+}
+
+static void DeactivateExternalPullup(DallasTemperature_HandleTypeDef* dt)
+{
+	if(dt->useExternalPullup)
+	{
+		HAL_GPIO_WritePin(GPIOC, GPIO_PIN_10, GPIO_PIN_SET);
+	}
+}
+
+// Sends a Match ROM query (0x55, address, command...) with a reset, as
+// OW_Send does. If the address is the only device a complete search of
+// the bus found, and skipRomSingle is set, the query goes out as Skip ROM
+// instead, which
+// saves the 64 address slots. query[8] is overwritten in that case.
+// Otherwise devices of the table get their prepared Match ROM frame and
+// only the command is encoded. 'device' is the table entry of the address
+// if the caller has it at hand, NULL to look it up
+static uint8_t SendAddressed(DallasTemperature_HandleTypeDef* dt, DallasTemperature_DeviceTypeDef* device, uint8_t* query, uint8_t cLen, uint8_t* data, uint8_t dLen, uint8_t readStart)
+{
+	if (dt->skipRomSingle && dt->singleDevice && dt->devices == 1 && memcmp(&query[1], dt->device[0].address, 8) == 0)
+	{
+		query[8] = 0xCC;
+		return OW_Send(dt->ow, OW_SEND_RESET, &query[8], cLen - 8, data, dLen, (readStart == OW_NO_READ) ? OW_NO_READ : readStart - 8);
+	}
+
+#if DT_MATCH_ROM_FRAMES
+	if (device == NULL)
+		device = FindDevice(dt, &query[1]);
+
+	if (device != NULL)
+		return OW_SendFrame(dt->ow, OW_SEND_RESET, device->matchRom, sizeof(device->matchRom), &query[9], cLen - 9, data, dLen, (readStart == OW_NO_READ) ? OW_NO_READ : readStart - 9);
+#endif
+
+	return OW_Send(dt->ow, OW_SEND_RESET, query, cLen, data, dLen, readStart);
+}
+
+// Classifies a scratchpad read for the bulk read functions.
+// Returns one of the DT_STATUS_... flags.
+static uint8_t ScratchPadStatus(const uint8_t* scratchPad, bool crcOk)
+{
+	uint8_t ones = 0xFF;
+
+	// nobody drove the bus during the read slots
+	for (uint8_t i = 0; i < 9; i++)
+		ones &= scratchPad[i];
+	if (ones == 0xFF)
+		return DT_STATUS_DISCONNECTED;
+
+	if (!crcOk)
+		return DT_STATUS_CRC_FAIL;
+
+	return DT_STATUS_OK;
+}
+
+// Reads only the two temperature bytes of a device, see DT_SetFastRead.
+// Without a CRC the value is checked for plausibility only: all ones (no
+// device driving the bus), the 85 C power-on value and anything outside
+// -55C - 125C are rejected.
+// Returns false if a full scratchpad read is due or needed instead
+static bool FastReadRaw(DallasTemperature_HandleTypeDef* dt, DallasTemperature_DeviceTypeDef* device, int16_t* raw)
+{
+	uint8_t query[12]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, READSCRATCH, 0xFF, 0xFF};
+	uint8_t temperature[2];
+
+	// DS1820 and DS18S20 need COUNT_REMAIN and COUNT_PER_C as well
+	if (dt->fastReadInterval == 0 || device->address[DSROM_FAMILY] == DS18S20MODEL)
+		return false;
+
+	if (device->fastReads >= dt->fastReadInterval)
+		return false;
+
+	// the rest of the scratchpad is not clocked out, the reset starting the
+	// next transaction ends the read
+	memcpy(&query[1], device->address, 8);
+	if (SendAddressed(dt, device, query, 12, temperature, 2, 10) != OW_OK)
+		return false;
+
+	int16_t t = (int16_t) ((temperature[TEMP_MSB] << 8) | temperature[TEMP_LSB]);
+
+	// all ones is also a genuine -0.0625 C, the two cannot be told apart
+	// without a CRC. at that temperature every read falls back to the full
+	// read, which gets it right at the cost of the 16 slots spent here
+	if (t == -1 || t == 0x0550 || t < -55 * 16 || t > 125 * 16)
+		return false;
+
+	device->fastReads++;
+	*raw = t << 3;
+	return true;
+}
+
+// Reads the temperature of one device of the table for the bulk read
+// functions. 'query' is a Match ROM scratchpad read, only the address is
+// replaced so the same query serves a whole sweep. Once a reset got no
+// presence pulse *present is false and later calls skip the bus.
+// Returns one of the DT_STATUS_... flags, *raw is always set.
+static uint8_t ReadDeviceRaw(DallasTemperature_HandleTypeDef* dt, uint8_t* query, uint16_t deviceIndex, int16_t* raw, bool* present)
+{
+	ScratchPad scratchPad;
+	uint8_t result = DT_STATUS_DISCONNECTED;
+	const uint8_t* deviceAddress = dt->device[deviceIndex].address;
+
+	*raw = DEVICE_DISCONNECTED_RAW;
+
+	// without a presence pulse the rest of the bus is gone as well
+	if (*present)
+	{
+		if (FastReadRaw(dt, &dt->device[deviceIndex], raw))
+			return DT_STATUS_OK;
+
+		memcpy(&query[1], deviceAddress, 8);
+		// the CRC is checked while the scratchpad is decoded
+		OW_StreamCrc(dt->ow, OW_CRC_8, 0);
+		*present = (SendAddressed(dt, &dt->device[deviceIndex], query, 19, scratchPad, 9, 10) == OW_OK);
+		if (*present)
+			result = ScratchPadStatus(scratchPad, OW_StreamCrcOk(dt->ow));
+		OW_StreamCrc(dt->ow, OW_CRC_NONE, 0);
+	}
+
+	if (result == DT_STATUS_OK)
+	{
+		*raw = DT_CalculateTemperature(deviceAddress, scratchPad);
+		StoreConfig(&dt->device[deviceIndex], scratchPad);
+		dt->device[deviceIndex].fastReads = 0;
+	}
+
+	return result;
+}
+
+// Returns the table entry of a device address, NULL if it is not in the
+// table of the last DT_Begin or DT_Rescan
+static DallasTemperature_DeviceTypeDef* FindDevice(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	for (uint16_t i = 0; i < dt->devices; i++)
+	{
+		if (memcmp(dt->device[i].address, deviceAddress, 8) == 0)
+			return &dt->device[i];
+	}
+
+	return NULL;
+}
+
+// Returns the resolution the conversion time of a device index is based on.
+// Devices of unknown resolution get the bus wide maximum
+static uint8_t DeviceResolution(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex)
+{
+	uint8_t resolution = dt->device[deviceIndex].resolution;
+
+	return (resolution != 0) ? resolution : dt->bitResolution;
+}
+
+// Returns the highest resolution the devices of the table hold, changes
+// held back by write-back mode not counted. 0 if none is known
+static uint8_t TableResolution(DallasTemperature_HandleTypeDef* dt)
+{
+	uint8_t bitResolution = 0;
+
+	for (uint16_t i = 0; i < dt->devices; i++)
+		bitResolution = max(bitResolution, dt->device[i].resolution);
+
+	return bitResolution;
+}
+
+// Returns the configuration register value for a resolution of 9-12 bits
+static uint8_t ResolutionToConfig(uint8_t bitResolution)
+{
+	switch (bitResolution)
+	{
+	case 12:
+		return TEMP_12_BIT;
+	case 11:
+		return TEMP_11_BIT;
+	case 10:
+		return TEMP_10_BIT;
+	case 9:
+	default:
+		return TEMP_9_BIT;
+	}
+}
+
+// Returns the resolution of a configuration register value, 0 if invalid
+static uint8_t ConfigToResolution(uint8_t config)
+{
+	switch (config)
+	{
+	case TEMP_12_BIT:
+		return 12;
+	case TEMP_11_BIT:
+		return 11;
+	case TEMP_10_BIT:
+		return 10;
+	case TEMP_9_BIT:
+		return 9;
+	default:
+		return 0;
+	}
+}
+
+// Sends TH, TL and the configuration register to the scratchpad of one
+// device, leaving the shadow alone.
+// Returns false if no device answered the reset
+static bool SendScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, const uint8_t* scratchPad)
+{
+	uint8_t query[13]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, WRITESCRATCH, scratchPad[HIGH_ALARM_TEMP], scratchPad[LOW_ALARM_TEMP], scratchPad[CONFIGURATION]};
+	uint8_t b;
+	memcpy(&query[1], deviceAddress, 8);
+
+	// DS1820 and DS18S20 have no configuration register
+	if (deviceAddress[DSROM_FAMILY] != DS18S20MODEL)
+	{
+		b = SendAddressed(dt, NULL, query, 13, NULL, 0, OW_NO_READ);
+	}
+	else
+	{
+		b = SendAddressed(dt, NULL, query, 12, NULL, 0, OW_NO_READ);
+	}
+
+	return (b == OW_OK);
+}
+
+// Writes TH, TL and the configuration register to the scratchpad of one
+// device without copying them to EEPROM.
+// Returns false if no device answered the reset
+static bool WriteScratchPadRam(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, const uint8_t* scratchPad)
+{
+	if (!SendScratchPad(dt, deviceAddress, scratchPad))
+		return false;
+
+	DallasTemperature_DeviceTypeDef* device = FindDevice(dt, deviceAddress);
+	if (device != NULL)
+	{
+#if REQUIRESALARMS
+		// the write replaced a change detection window
+		device->windowed = false;
+		device->inWindow = false;
+#endif
+		StoreConfig(device, scratchPad);
+	}
+
+	return true;
+}
+
+// Updates the configuration shadow of a device from a scratchpad image
+// the device holds. The resolution always follows the device, changes held
+// back by write-back mode are kept until they are flushed
+static void StoreConfig(DallasTemperature_DeviceTypeDef* device, const uint8_t* scratchPad)
+{
+	// DS1820 and DS18S20 have no resolution configuration register
+	if (device->address[DSROM_FAMILY] == DS18S20MODEL)
+		device->resolution = 12;
+	else if (ConfigToResolution(scratchPad[CONFIGURATION]) != 0)
+		device->resolution = ConfigToResolution(scratchPad[CONFIGURATION]);
+
+	if (device->configDirty)
+		return;
+
+	device->highAlarm = scratchPad[HIGH_ALARM_TEMP];
+	device->lowAlarm = scratchPad[LOW_ALARM_TEMP];
+#if REQUIRESALARMS
+	// a change detection window is not the TH/TL set for the device
+	if (device->windowed)
+	{
+		device->highAlarm = device->savedHigh;
+		device->lowAlarm = device->savedLow;
+	}
+#endif
+	device->config = scratchPad[CONFIGURATION];
+	device->configValid = true;
+}
+
+// Puts a scratchpad write into the shadow only, for DT_FlushConfig to
+// write it to the device later
+static void HoldConfig(DallasTemperature_DeviceTypeDef* device, const uint8_t* scratchPad)
+{
+	device->highAlarm = scratchPad[HIGH_ALARM_TEMP];
+	device->lowAlarm = scratchPad[LOW_ALARM_TEMP];
+	device->config = scratchPad[CONFIGURATION];
+	device->configValid = true;
+	device->configDirty = true;
+}
+
+// Fills TH, TL and the configuration register of scratchPad, from the
+// shadow when it is valid, from the device otherwise.
+// Returns false if the device could not be read
+static bool ReadConfig(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t* scratchPad)
+{
+	DallasTemperature_DeviceTypeDef* device = FindDevice(dt, deviceAddress);
+
+	if (device == NULL || !device->configValid)
+		return DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad);
+
+	scratchPad[HIGH_ALARM_TEMP] = device->highAlarm;
+	scratchPad[LOW_ALARM_TEMP] = device->lowAlarm;
+	scratchPad[CONFIGURATION] = device->config;
+
+	return true;
+}
+
+// Returns true if all bytes of scratchPad are '\0'
+//static bool IsAllZeros(const uint8_t * const scratchPad, const size_t length)
+//{
+//	for (size_t i = 0; i < length; i++)
+//	{
+//		if (scratchPad[i] != 0)
+//		{
+//			return false;
+//		}
+//	}
+//
+//	return true;
+//}
+
+void DT_SetPullupPin(DallasTemperature_HandleTypeDef* dt, GPIO_TypeDef* port, uint32_t pin)
+{
+	dt->useExternalPullup = true;
+
+	/*Configure GPIO pin : ONE_WIRE_Pin */
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	GPIO_InitStruct.Pin = pin;
+	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_MEDIUM;
+	HAL_GPIO_Init(port, &GPIO_InitStruct);
+
+	DeactivateExternalPullup(dt);
+}
+
+void DT_SetOneWire(DallasTemperature_HandleTypeDef* dt, OneWire_HandleTypeDef* ow)
+{
+	dt->ow 					= ow;
+	// nothing of a handle not set up yet to forget
+	dt->devices 			= 0;
+	DT_SetDeviceTable(dt, NULL, 0);
+	dt->parasite 			= false;
+	dt->bitResolution 		= 9;
+	dt->waitForConversion 	= true;
+	dt->checkForConversion 	= true;
+	dt->autoSaveScratchPad 	= true;
+	dt->writeBack 			= false;
+	dt->skipRomSingle 		= true;
+	dt->sensorSearch 		= false;
+	dt->fastReadInterval 	= 0;
+	dt->useExternalPullup 	= false;
+	dt->converting 			= false;
+	dt->newData 			= false;
+	dt->updating 			= false;
+	dt->_AddedHandler 		= NO_DEVICE_HANDLER;
+	dt->_RemovedHandler 	= NO_DEVICE_HANDLER;
+#if REQUIRESALARMS
+	dt->_AlarmHandler 		= NO_ALARM_HANDLER;
+	dt->changeDeadband 		= 0;
+#endif
+}
+
+// Use 'table' ('capacity' entries) for the devices found by DT_Begin and
+// DT_Rescan instead of the ONEWIRE_MAX_DEVICES entries built into the
+// handle. The table must stay valid while the handle is in use.  Pass NULL
+// to go back to the built-in table.  Forgets the devices found so far,
+// after putting back the TH/TL their change detection windows replaced.
+void DT_SetDeviceTable(DallasTemperature_HandleTypeDef* dt, DallasTemperature_DeviceTypeDef* table, uint16_t capacity)
+{
+#if REQUIRESALARMS
+	RestoreWindows(dt, NULL);
+#endif
+
+	if (table == NULL || capacity == 0)
+	{
+		table = dt->deviceStorage;
+		capacity = ONEWIRE_MAX_DEVICES;
+	}
+
+	dt->device = table;
+	dt->deviceCapacity = capacity;
+	dt->devices = 0;
+	dt->ds18Count = 0;
+	dt->deviceOverflow = false;
+	dt->singleDevice = false;
+	dt->converting = false;
+}
+
+void DT_Begin(DallasTemperature_HandleTypeDef* dt)
+{
+	DT_Rescan(dt);
+
+	for(uint16_t i = 0; i < dt->devices; i++)
+		ProbeDevice(dt, &dt->device[i]);
+}
+
+// fresh table entry for the device whose address is already set
+static void InitDevice(DallasTemperature_DeviceTypeDef* device)
+{
+#if DT_MATCH_ROM_FRAMES
+	OW_ToSlots((const uint8_t*) "\x55", 1, device->matchRom);
+	OW_ToSlots(device->address, 8, &device->matchRom[8]);
+#endif
+	device->raw = DEVICE_DISCONNECTED_RAW;
+	device->status = DT_STATUS_DISCONNECTED;
+	device->resolution = 0;
+	device->pending = false;
+	device->configValid = false;
+	device->configDirty = false;
+	device->fastReads = 0;
+#if REQUIRESALARMS
+	device->windowed = false;
+	device->inWindow = false;
+#endif
+}
+
+// reads power mode and resolution of a device new to the table
+static void ProbeDevice(DallasTemperature_HandleTypeDef* dt, DallasTemperature_DeviceTypeDef* device)
+{
+	const uint8_t* deviceAddress = device->address;
+
+	if (DT_ValidAddress(deviceAddress))
+	{
+
+		if (!dt->parasite && DT_ReadPowerSupply(dt, deviceAddress))
+			dt->parasite = true;
+
+		device->resolution = DT_GetResolution(dt, deviceAddress);
+		dt->bitResolution = max(dt->bitResolution, device->resolution);
+	}
+}
+
+// counts the DS18xxx devices of the table for DT_GetDS18Count, after
+// every change of the table
+static void CountSensors(DallasTemperature_HandleTypeDef* dt)
+{
+	dt->ds18Count = 0;
+
+	for (uint16_t i = 0; i < dt->devices; i++)
+	{
+		if (DT_ValidAddress(dt->device[i].address) && DT_ValidFamily(dt->device[i].address))
+			dt->ds18Count++;
+	}
+}
+
+// searches the bus again and refreshes the table of device addresses
+// used by DT_GetAddress and the ...ByIndex functions.  The devices are
+// found one at a time straight into the table, so the stack use does not
+// depend on the size of the bus.  If the bus holds more devices than the
+// table DT_GetDeviceOverflow() reports it, the table keeps the first ones.
+// returns the number of devices found
+uint16_t DT_Rescan(DallasTemperature_HandleTypeDef* dt)
+{
+	uint8_t spare[8];
+
+#if REQUIRESALARMS
+	// the new entries know nothing of the windows the devices still hold,
+	// the next probe or read would take them for the TH/TL set
+	RestoreWindows(dt, NULL);
+#endif
+
+	dt->devices = 0;
+	dt->deviceOverflow = false;
+	dt->singleDevice = false;
+
+	for (uint8_t pass = 0; pass < SearchPasses(dt) && !dt->deviceOverflow; pass++)
+	{
+		StartSearchPass(dt, pass);
+		while (dt->devices < dt->deviceCapacity && OW_SearchNext(dt->ow, dt->device[dt->devices].address))
+			dt->devices++;
+
+		// one more search tells a full table from an overflowing one
+		if (dt->devices == dt->deviceCapacity && OW_SearchNext(dt->ow, spare))
+			dt->deviceOverflow = true;
+	}
+
+	for(uint16_t i = 0; i < dt->devices; i++)
+		InitDevice(&dt->device[i]);
+	CountSensors(dt);
+
+	// a search cut short by a bus error may have missed devices, one
+	// restricted to the sensor families misses the others anyway
+	dt->singleDevice = (dt->devices == 1 && !dt->deviceOverflow && !dt->sensorSearch && dt->ow->LastDeviceFlag);
+	dt->converting = false;
+
+	return dt->devices;
+}
+
+// searches of a rescan: one per family of SensorFamilies with sensorSearch
+static uint8_t SearchPasses(DallasTemperature_HandleTypeDef* dt)
+{
+	return dt->sensorSearch ? sizeof(SensorFamilies) : 1;
+}
+
+static void StartSearchPass(DallasTemperature_HandleTypeDef* dt, uint8_t pass)
+{
+	if (dt->sensorSearch)
+		OW_TargetSearch(dt->ow, SensorFamilies[pass]);
+	else
+		OW_ResetSearch(dt->ow);
+}
+
+// true if the search finds ROM code a before ROM code b: bits go from the
+// LSB of the family code up, at the first difference 1 comes first
+static bool SearchesBefore(const uint8_t* a, const uint8_t* b)
+{
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		uint8_t diff = a[i] ^ b[i];
+
+		if (diff != 0)
+			return (a[i] & diff & -diff) != 0;
+	}
+
+	return false;
+}
+
+// puts a device new on the bus into the table at deviceIndex, keeping
+// the search order, and probes it
+static void InsertDevice(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex, const uint8_t* deviceAddress)
+{
+	DallasTemperature_DeviceTypeDef* device = &dt->device[deviceIndex];
+
+	memmove(device + 1, device, (dt->devices - deviceIndex) * sizeof(*device));
+	dt->devices++;
+
+	memcpy(device->address, deviceAddress, 8);
+	InitDevice(device);
+	ProbeDevice(dt, device);
+
+	if (dt->_AddedHandler != NO_DEVICE_HANDLER)
+		dt->_AddedHandler(device->address);
+}
+
+// drops a device gone from the bus from the table
+static void RemoveDevice(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex)
+{
+	DallasTemperature_DeviceTypeDef* device = &dt->device[deviceIndex];
+
+	if (dt->_RemovedHandler != NO_DEVICE_HANDLER)
+		dt->_RemovedHandler(device->address);
+
+	dt->devices--;
+	memmove(device, device + 1, (dt->devices - deviceIndex) * sizeof(*device));
+}
+
+// searches the bus again and brings the device table up to date without
+// starting over: devices still there keep their entry, their samples and
+// configuration shadow, devices gone are dropped and new ones are probed
+// for power mode and resolution like DT_Begin does. The added and removed
+// handlers run for every change. A search cut short by a bus error only
+// adds the devices found up to there.
+// returns the number of devices added or removed
+uint16_t DT_UpdateDevices(DallasTemperature_HandleTypeDef* dt)
+{
+	uint16_t changes;
+
+	// 64 triplets finish a device per step
+	while (!DT_UpdateDevicesStep(dt, 64, &changes))
+		;
+
+	return changes;
+}
+
+// DT_UpdateDevices spread over several calls, so the main loop keeps
+// running during discovery: every call searches at most 'maxTriplets' ROM
+// bits, plus the probe of a device if a new one is complete. Starting from
+// an empty table this is a time sliced DT_Begin. Keep the bus free for
+// the search until it is done.
+// returns true when the update is done, changes (may be NULL) then gets
+// the number of devices added or removed
+bool DT_UpdateDevicesStep(DallasTemperature_HandleTypeDef* dt, uint8_t maxTriplets, uint16_t* changes)
+{
+	uint8_t deviceAddress[8];
+
+	if (!dt->updating)
+	{
+		dt->updating = true;
+		dt->updateIndex = 0;
+		dt->updateChanges = 0;
+		dt->updatePass = 0;
+		dt->deviceOverflow = false;
+		dt->singleDevice = false;
+		StartSearchPass(dt, 0);
+	}
+
+	uint8_t result = OW_SearchStep(dt->ow, deviceAddress, maxTriplets);
+
+	if (result == OW_BUSY)
+		return false;
+
+	// the family of the pass is not on the bus, or nobody is (no
+	// presence pulse at all: everybody left)
+	if (result == OW_NO_DEVICE && dt->ow->LastDeviceFlag)
+		return NextUpdatePass(dt, changes);
+
+	if (result != OW_OK || !DT_ValidAddress(deviceAddress))
+		return FinishUpdate(dt, false, changes);
+
+	// the search runs in table order, so entries before the device found
+	// are gone
+	while (dt->updateIndex < dt->devices && SearchesBefore(dt->device[dt->updateIndex].address, deviceAddress))
+	{
+		RemoveDevice(dt, dt->updateIndex);
+		dt->updateChanges++;
+	}
+
+	if (dt->updateIndex < dt->devices && memcmp(dt->device[dt->updateIndex].address, deviceAddress, 8) == 0)
+	{
+		dt->updateIndex++;
+	}
+	else if (dt->devices < dt->deviceCapacity)
+	{
+		InsertDevice(dt, dt->updateIndex, deviceAddress);
+		dt->updateChanges++;
+		dt->updateIndex++;
+	}
+	else
+	{
+		dt->deviceOverflow = true;
+	}
+
+	// the last device found ends a search that went through
+	if (!dt->ow->LastDeviceFlag)
+		return false;
+
+	return NextUpdatePass(dt, changes);
+}
+
+// moves DT_UpdateDevicesStep on to the next family of a sensor search
+static bool NextUpdatePass(DallasTemperature_HandleTypeDef* dt, uint16_t* changes)
+{
+	if (++dt->updatePass < SearchPasses(dt))
+	{
+		StartSearchPass(dt, dt->updatePass);
+		return false;
+	}
+
+	return FinishUpdate(dt, true, changes);
+}
+
+// ends DT_UpdateDevicesStep, 'complete' if the search went through
+static bool FinishUpdate(DallasTemperature_HandleTypeDef* dt, bool complete, uint16_t* changes)
+{
+	// entries after the last device found are gone as well
+	while (complete && dt->updateIndex < dt->devices)
+	{
+		RemoveDevice(dt, dt->updateIndex);
+		dt->updateChanges++;
+	}
+
+	if (dt->updateChanges != 0)
+		dt->converting = false;
+	CountSensors(dt);
+
+	dt->singleDevice = (complete && dt->devices == 1 && !dt->deviceOverflow && !dt->sensorSearch);
+	dt->updating = false;
+
+	if (changes != NULL)
+		*changes = dt->updateChanges;
+
+	return true;
+}
+
+// checks that the devices of the table are still on the bus without a
+// search: with scratchPad the scratchpad of every device is read and a
+// device is gone if nobody answers the read slots, which also refreshes
+// the configuration shadow. Otherwise OW_Verify follows the ROM code of
+// every device, which works for any family. Devices gone are dropped and
+// the removed handler runs for them; new devices need DT_UpdateDevices.
+// Does nothing while DT_UpdateDevicesStep is in progress.
+// returns the number of devices removed
+uint16_t DT_CheckDevices(DallasTemperature_HandleTypeDef* dt, bool scratchPad)
+{
+	uint16_t removed = 0;
+	uint16_t i = 0;
+	bool skipRomSingle = dt->skipRomSingle;
+
+	// the update walks the table and the search state of the handle
+	if (dt->updating)
+		return 0;
+
+	// a device swapped in for the only one would answer a Skip ROM
+	dt->skipRomSingle = false;
+
+	while (i < dt->devices)
+	{
+		bool present;
+
+		if (scratchPad)
+		{
+			ScratchPad data;
+
+			OW_StreamCrc(dt->ow, OW_CRC_8, 0);
+			present = DT_ReadScratchPad(dt, dt->device[i].address, data);
+			bool crcOk = OW_StreamCrcOk(dt->ow);
+			OW_StreamCrc(dt->ow, OW_CRC_NONE, 0);
+
+			// a CRC error still means somebody answered
+			if (present && ScratchPadStatus(data, crcOk) == DT_STATUS_DISCONNECTED)
+				present = false;
+			else if (present && crcOk)
+				StoreConfig(&dt->device[i], data);
+		}
+		else
+		{
+			present = OW_Verify(dt->ow, dt->device[i].address);
+		}
+
+		if (present)
+		{
+			i++;
+		}
+		else
+		{
+			RemoveDevice(dt, i);
+			removed++;
+		}
+	}
+
+	dt->skipRomSingle = skipRomSingle;
+
+	if (removed != 0)
+	{
+		dt->converting = false;
+		CountSensors(dt);
+	}
+
+	return removed;
+}
+
+// sets the functions called with the address of every device
+// DT_UpdateDevices adds or DT_UpdateDevices/DT_CheckDevices removes,
+// NO_DEVICE_HANDLER for none
+void DT_SetDeviceHandlers(DallasTemperature_HandleTypeDef* dt, DeviceHandler *added, DeviceHandler *removed)
+{
+	dt->_AddedHandler = added;
+	dt->_RemovedHandler = removed;
+}
+
+// returns the number of devices found on the bus
+uint16_t DT_GetDeviceCount(DallasTemperature_HandleTypeDef* dt)
+{
+	return dt->devices;
+}
+
+uint16_t DT_GetDS18Count(DallasTemperature_HandleTypeDef* dt)
+{
+	return dt->ds18Count;
+}
+
+// returns true if the last DT_Begin or DT_Rescan found more devices than
+// the device table holds
+bool DT_GetDeviceOverflow(DallasTemperature_HandleTypeDef* dt)
+{
+	return dt->deviceOverflow;
+}
+
+// returns true if address is valid
+bool DT_ValidAddress(const uint8_t* deviceAddress)
+{
+	return (OW_Crc8(deviceAddress, 7) == deviceAddress[7]);
+}
+
+bool DT_ValidFamily(const uint8_t* deviceAddress)
+{
+	switch (deviceAddress[DSROM_FAMILY])
+	{
+	case DS18S20MODEL:
+	case DS18B20MODEL:
+	case DS1822MODEL:
+	case DS1825MODEL:
+	case DS28EA00MODEL:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// finds an address at a given index on the bus, as found by the last
+// DT_Begin or DT_Rescan. Does not touch the bus.
+// returns true if the device was found
+bool DT_GetAddress(DallasTemperature_HandleTypeDef* dt, uint8_t* currentDeviceAddress, uint16_t index)
+{
+	if(index < dt->devices && DT_ValidAddress(dt->device[index].address))
+	{
+		memcpy(currentDeviceAddress, dt->device[index].address, 8);
+		return true;
+	}
+
+	return false;
+}
+
+// attempt to determine if the device at the given address is connected to the bus
+bool DT_IsConnected(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	ScratchPad scratchPad;
+	return DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad);
+}
+
+// attempt to determine if the device at the given address is connected to the bus
+// also allows for updating the read scratchpad
+bool DT_IsConnected_ScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t* scratchPad)
+{
+	// the CRC is checked while the scratchpad is decoded
+	OW_StreamCrc(dt->ow, OW_CRC_8, 0);
+	bool b = DT_ReadScratchPad(dt, deviceAddress, scratchPad);
+	bool crcOk = OW_StreamCrcOk(dt->ow);
+	OW_StreamCrc(dt->ow, OW_CRC_NONE, 0);
+
+	if (!b /*|| IsAllZeros(scratchPad, 8)*/ || !crcOk)
+		return false;
+
+	DallasTemperature_DeviceTypeDef* device = FindDevice(dt, deviceAddress);
+	if (device != NULL)
+	{
+		StoreConfig(device, scratchPad);
+		device->fastReads = 0;
+	}
+
+	return true;
+}
+
+bool DT_ReadScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t* scratchPad)
+{
+	uint8_t query[19]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, READSCRATCH, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+	memcpy(&query[1], deviceAddress, 8);
+
+	// Read all registers in a simple loop
+	// byte 0: temperature LSB
+	// byte 1: temperature MSB
+	// byte 2: high alarm temp
+	// byte 3: low alarm temp
+	// byte 4: DS18S20: store for crc
+	//         DS18B20 & DS1822: configuration register
+	// byte 5: internal use & crc
+	// byte 6: DS18S20: COUNT_REMAIN
+	//         DS18B20 & DS1822: store for crc
+	// byte 7: DS18S20: COUNT_PER_C
+	//         DS18B20 & DS1822: store for crc
+	// byte 8: SCRATCHPAD_CRC
+
+	// the reset fails fast if nothing is on the bus
+	uint8_t b = SendAddressed(dt, NULL, query, 19, scratchPad, 9, 10);
+
+	return (b == OW_OK);
+}
+
+void DT_WriteScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, const uint8_t* scratchPad)
+{
+	DallasTemperature_DeviceTypeDef* device = FindDevice(dt, deviceAddress);
+
+	// write-back mode: the device is written by DT_FlushConfig
+	if (dt->writeBack && device != NULL)
+	{
+		HoldConfig(device, scratchPad);
+		return;
+	}
+
+	WriteScratchPadRam(dt, deviceAddress, scratchPad);
+
+	if (dt->autoSaveScratchPad)
+	{
+		DT_SaveScratchPad(dt, deviceAddress);
+	}
+}
+
+// returns true if parasite mode is used (2 wire)
+// returns false if normal mode is used (3 wire)
+// if no address is given (or nullptr) it checks if any device on the bus
+// uses parasite mode. returns false if no device answered the reset.
+bool DT_ReadPowerSupply(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	uint8_t parasiteMode = 0;
+	uint8_t b;
+
+	uint8_t query[11]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, READPOWERSUPPLY, 0xFF};
+
+	if (deviceAddress == NULL)
+	{
+	  query[0] = 0xCC;
+	  query[1] = READPOWERSUPPLY;
+	  query[2] = 0xFF;
+	  b = OW_Send(dt->ow, OW_SEND_RESET, query, 3, &parasiteMode, 1, 2);
+	}
+	else
+	{
+	  query[0] = 0x55;
+	  memcpy(&query[1], deviceAddress, 8);
+	  b = SendAddressed(dt, NULL, query, 11, &parasiteMode, 1, 10);
+	}
+
+	// without a presence pulse nothing was read, which says nothing
+	// about parasite power
+	if (b != OW_OK)
+		return false;
+
+	if (parasiteMode == 0)
+	{
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+// set resolution of all devices to 9, 10, 11, or 12 bits
+// if new resolution is out of range, it is constrained.
+// every device's scratchpad is read once and only written if its resolution
+// differs, TH/TL (alarms or user data) are kept. with autoSaveScratchPad a
+// single broadcast Copy Scratchpad stores all of them at the end
+void DT_SetAllResolution(DallasTemperature_HandleTypeDef* dt, uint8_t newResolution)
+{
+	uint8_t bitResolution = constrain(newResolution, 9, 12);
+	uint8_t config = ResolutionToConfig(bitResolution);
+	bool written = false;
+
+	for (uint16_t i = 0; i < dt->devices; i++)
+	{
+		DallasTemperature_DeviceTypeDef* device = &dt->device[i];
+		ScratchPad scratchPad;
+
+		// DS1820 and DS18S20 have no resolution configuration register
+		if (device->address[DSROM_FAMILY] == DS18S20MODEL)
+			continue;
+
+		if (!ReadConfig(dt, device->address, scratchPad))
+			continue;
+
+		if (scratchPad[CONFIGURATION] != config)
+		{
+			scratchPad[CONFIGURATION] = config;
+
+			if (dt->writeBack)
+			{
+				HoldConfig(device, scratchPad);
+			}
+			else
+			{
+				WriteScratchPadRam(dt, device->address, scratchPad);
+				written = true;
+			}
+		}
+	}
+
+	if (written && dt->autoSaveScratchPad)
+		DT_SaveScratchPad(dt, NULL);
+
+	// devices with a change held back keep converting at their old
+	// resolution until DT_FlushConfig
+	uint8_t known = TableResolution(dt);
+	dt->bitResolution = (known != 0) ? known : bitResolution;
+}
+
+// writes the same TH, TL and resolution to all devices with one Skip ROM
+// Write Scratchpad, followed (with autoSaveScratchPad) by one broadcast
+// Copy Scratchpad. DS1820/DS18S20 take TH and TL and ignore the rest.
+// with verify every device's scratchpad is read back afterwards.
+// returns false if no device answered or a device failed verification
+bool DT_ConfigureAll(DallasTemperature_HandleTypeDef* dt, int8_t highAlarm, int8_t lowAlarm, uint8_t newResolution, bool verify)
+{
+	newResolution = constrain(newResolution, 9, 12);
+
+	uint8_t query[5]={0xCC, WRITESCRATCH, (uint8_t) highAlarm, (uint8_t) lowAlarm, ResolutionToConfig(newResolution)};
+
+	if (OW_Send(dt->ow, OW_SEND_RESET, query, 5, NULL, 0, OW_NO_READ) != OW_OK)
+		return false;
+
+	if (dt->autoSaveScratchPad && !DT_SaveScratchPad(dt, NULL))
+		return false;
+
+	dt->bitResolution = newResolution;
+
+	for (uint16_t i = 0; i < dt->devices; i++)
+	{
+		DallasTemperature_DeviceTypeDef* device = &dt->device[i];
+
+		device->highAlarm = query[2];
+		device->lowAlarm = query[3];
+		device->configDirty = false;
+#if REQUIRESALARMS
+		device->windowed = false;
+		device->inWindow = false;
+#endif
+
+		// DS1820 and DS18S20 have no resolution configuration register
+		if (device->address[DSROM_FAMILY] == DS18S20MODEL)
+		{
+			device->resolution = 12;
+		}
+		else
+		{
+			device->config = query[4];
+			device->configValid = true;
+			device->resolution = newResolution;
+		}
+		dt->bitResolution = max(dt->bitResolution, device->resolution);
+	}
+
+	if (!verify)
+		return true;
+
+	bool ok = true;
+
+	for (uint16_t i = 0; i < dt->devices; i++)
+	{
+		DallasTemperature_DeviceTypeDef* device = &dt->device[i];
+		ScratchPad scratchPad;
+
+		if (!DT_IsConnected_ScratchPad(dt, device->address, scratchPad)
+				|| scratchPad[HIGH_ALARM_TEMP] != query[2] || scratchPad[LOW_ALARM_TEMP] != query[3])
+		{
+			ok = false;
+			continue;
+		}
+
+		if (device->address[DSROM_FAMILY] != DS18S20MODEL && scratchPad[CONFIGURATION] != query[4])
+			ok = false;
+	}
+
+	return ok;
+}
+
+// drops the configuration shadow of a device, or of all devices if
+// deviceAddress is NULL, so the next configuration query reads the device.
+// needed after anything outside this library changed a scratchpad.
+// changes not flushed yet are dropped as well
+void DT_InvalidateConfig(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	for (uint16_t i = 0; i < dt->devices; i++)
+	{
+		if (deviceAddress == NULL || memcmp(dt->device[i].address, deviceAddress, 8) == 0)
+		{
+			dt->device[i].configValid = false;
+			dt->device[i].configDirty = false;
+#if REQUIRESALARMS
+			dt->device[i].windowed = false;
+			dt->device[i].inWindow = false;
+#endif
+		}
+	}
+}
+
+// reads the scratchpad of every device to refill the configuration shadow,
+// dropping changes not flushed yet.
+// returns the number of devices read successfully
+uint8_t DT_RefreshConfig(DallasTemperature_HandleTypeDef* dt)
+{
+	uint8_t good = 0;
+
+	for (uint16_t i = 0; i < dt->devices; i++)
+	{
+		ScratchPad scratchPad;
+
+		dt->device[i].configValid = false;
+		dt->device[i].configDirty = false;
+		if (DT_IsConnected_ScratchPad(dt, dt->device[i].address, scratchPad))
+			good++;
+	}
+
+	return good;
+}
+
+// set resolution of a device to 9, 10, 11, or 12 bits
+// if new resolution is out of range, 9 bits is used.
+bool DT_SetResolution(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t newResolution, bool skipGlobalBitResolutionCalculation)
+{
+	// ensure same behavior as setResolution(uint8_t newResolution)
+	newResolution = constrain(newResolution, 9, 12);
+
+	ScratchPad scratchPad;
+
+	if (ReadConfig(dt, deviceAddress, scratchPad))
+	{
+		// DS1820 and DS18S20 have no resolution configuration register,
+		// nothing to do either when stored value == new value
+		if (deviceAddress[DSROM_FAMILY] != DS18S20MODEL && ConfigToResolution(scratchPad[CONFIGURATION]) != newResolution)
+		{
+			scratchPad[CONFIGURATION] = ResolutionToConfig(newResolution);
+			DT_WriteScratchPad(dt, deviceAddress, scratchPad);
+
+			if (skipGlobalBitResolutionCalculation)
+			{
+				// without calculation we can always set it to max
+				dt->bitResolution = max(dt->bitResolution, newResolution);
+			}
+			else
+			{
+				// the table holds what the devices do, a change held back
+				// by write-back mode counts once it is flushed. a device
+				// outside the table is written at once
+				uint8_t bitResolution = (FindDevice(dt, deviceAddress) == NULL) ? newResolution : 0;
+				dt->bitResolution = max(bitResolution, TableResolution(dt));
+				if (dt->bitResolution == 0)
+					dt->bitResolution = newResolution;
+			}
+		}
+		return true;  // new value set
+	}
+	return false;
+}
+
+// returns the global resolution
+uint8_t DT_GetAllResolution(DallasTemperature_HandleTypeDef* dt)
+{
+	return dt->bitResolution;
+}
+
+// returns the current resolution of the device, 9-12
+// returns 0 if device not found
+uint8_t DT_GetResolution(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	// DS1820 and DS18S20 have no resolution configuration register
+	if (deviceAddress[0] == DS18S20MODEL)
+		return 12;
+
+	ScratchPad scratchPad;
+	if (ReadConfig(dt, deviceAddress, scratchPad))
+	{
+		return ConfigToResolution(scratchPad[CONFIGURATION]);
+	}
+	return 0;
+}
+
+// sets the value of the waitForConversion flag
+// TRUE : function requestTemperature() etc returns when conversion is ready
+// FALSE: function requestTemperature() etc returns immediately (USE WITH CARE!!)
+//        (1) programmer has to check if the needed delay has passed
+//        (2) but the application can do meaningful things in that time
+void DT_SetWaitForConversion(DallasTemperature_HandleTypeDef* dt, bool flag)
+{
+	dt->waitForConversion = flag;
+}
+
+// gets the value of the waitForConversion flag
+bool DT_GetWaitForConversion(DallasTemperature_HandleTypeDef* dt)
+{
+	return dt->waitForConversion;
+}
+
+// sets the value of the checkForConversion flag
+// TRUE : function requestTemperature() etc will 'listen' to an IC to determine whether a conversion is complete
+// FALSE: function requestTemperature() etc will wait a set time (worst case scenario) for a conversion to complete
+void DT_SetCheckForConversion(DallasTemperature_HandleTypeDef* dt, bool flag)
+{
+	dt->checkForConversion = flag;
+}
+
+// gets the value of the waitForConversion flag
+bool DT_GetCheckForConversion(DallasTemperature_HandleTypeDef* dt)
+{
+	return dt->checkForConversion;
+}
+
+// issues a read slot: externally powered devices hold the bus low while a
+// conversion is running, so it reads 1 once all of them are done.
+// only meaningful directly after a Convert T, with no other traffic on the
+// bus in between; parasite powered devices cannot answer at all.
+bool DT_IsConversionComplete(DallasTemperature_HandleTypeDef* dt)
+{
+	return (OW_ReadBit(dt->ow) == 1);
+}
+
+// sends command for all devices on the bus to perform a temperature conversion
+void DT_RequestTemperatures(DallasTemperature_HandleTypeDef* dt)
+{
+	OW_Send(dt->ow, OW_SEND_RESET, (uint8_t *) "\xcc\x44", 2, (uint8_t *) NULL, 0, OW_NO_READ);
+
+	// ASYNC mode?
+	if (!dt->waitForConversion)
+		return;
+
+	BlockTillConversionComplete(dt, dt->bitResolution);
+}
+
+// sends command for one device to perform a temperature by address
+// returns FALSE if device is disconnected
+// returns TRUE  otherwise
+bool DT_RequestTemperaturesByAddress(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	uint8_t bitResolution = DT_GetResolution(dt, deviceAddress);
+
+	if (bitResolution == 0)
+	{
+		return false; //Device disconnected
+	}
+
+	uint8_t query[10]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, STARTCONVO};
+	memcpy(&query[1], deviceAddress, 8);
+	SendAddressed(dt, NULL, query, 10, NULL, 0, OW_NO_READ);
+
+	// ASYNC mode?
+	if (!dt->waitForConversion)
+		return true;
+
+	BlockTillConversionComplete(dt, dt->bitResolution);
+
+	return true;
+}
+
+// sends command for one device to perform a temp conversion by index
+bool DT_RequestTemperaturesByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex)
+{
+	CurrentDeviceAddress deviceAddress;
+	DT_GetAddress(dt, deviceAddress, deviceIndex);
+
+	return DT_RequestTemperaturesByAddress(dt, deviceAddress);
+}
+
+// returns number of milliseconds to wait till conversion is complete (based on IC datasheet)
+int16_t DT_MillisToWaitForConversion(uint8_t bitResolution)
+{
+	switch (bitResolution)
+	{
+	case 9:
+		return 94;
+	case 10:
+		return 188;
+	case 11:
+		return 375;
+	default:
+		return 750;
+	}
+}
+
+// returns the number of milliseconds between two conversion complete polls.
+// a thirty-second of the worst case time keeps the delay behind the actual
+// end of a conversion small relative to its length, at one read slot a poll
+uint16_t DT_MillisBetweenConversionPolls(uint8_t bitResolution)
+{
+	return max(1, DT_MillisToWaitForConversion(bitResolution) / 32);
+}
+
+// starts a conversion on all devices and returns at once, independent of
+// waitForConversion. Call DT_Service from the main loop to collect the
+// results. returns false if no device answered the reset
+bool DT_StartConversion(DallasTemperature_HandleTypeDef* dt)
+{
+	if (OW_Send(dt->ow, OW_SEND_RESET, (uint8_t *) "\xcc\x44", 2, (uint8_t *) NULL, 0, OW_NO_READ) != OW_OK)
+		return false;
+
+	// parasite powered devices need the strong pullup during the conversion
+	if (dt->parasite)
+		ActivateExternalPullup(dt);
+
+	dt->converting = true;
+	dt->conversionStart = HAL_GetTick();
+	dt->conversionPoll = 0;
+	dt->conversionPending = dt->devices;
+
+	for (uint16_t i = 0; i < dt->devices; i++)
+		dt->device[i].pending = true;
+
+	return true;
+}
+
+// advances the conversion started by DT_StartConversion without blocking.
+// every device is read into the sample table as soon as the conversion time
+// of its own resolution has passed, so fast low resolution devices do not
+// wait for slow ones on the same bus. with checkForConversion on an
+// externally powered bus the remaining devices are read as soon as a read
+// slot reports that all conversions are done; that poll is only meaningful
+// until the first device has been read.
+// parasite powered devices need the strong pullup until the slowest of them
+// is done, there all devices are read at the bus wide conversion time.
+// returns true when a new set of samples has been stored
+bool DT_Service(DallasTemperature_HandleTypeDef* dt)
+{
+	if (!dt->converting)
+		return false;
+
+	uint32_t elapsed = HAL_GetTick() - dt->conversionStart;
+	bool complete = (elapsed >= (uint32_t) DT_MillisToWaitForConversion(dt->bitResolution));
+
+	if (!complete && dt->checkForConversion && !dt->parasite && dt->conversionPending == dt->devices
+			&& elapsed - dt->conversionPoll >= DT_MillisBetweenConversionPolls(dt->bitResolution))
+	{
+		dt->conversionPoll = elapsed;
+		complete = DT_IsConversionComplete(dt);
+	}
+
+	if (!complete && dt->parasite)
+		return false;
+
+	if (complete)
+		DeactivateExternalPullup(dt);
+
+	uint8_t query[19]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, READSCRATCH, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+	bool present = true;
+
+	for (uint16_t i = 0; i < dt->devices; i++)
+	{
+		DallasTemperature_DeviceTypeDef* device = &dt->device[i];
+
+		if (!device->pending)
+			continue;
+
+		if (!complete && elapsed < (uint32_t) DT_MillisToWaitForConversion(DeviceResolution(dt, i)))
+			continue;
+
+		device->status = ReadDeviceRaw(dt, query, i, &device->raw, &present);
+		device->pending = false;
+		dt->conversionPending--;
+	}
+
+	if (dt->conversionPending != 0)
+		return false;
+
+	dt->converting = false;
+	dt->newData = true;
+	return true;
+}
+
+// returns true while a conversion started by DT_StartConversion is pending
+bool DT_IsConverting(DallasTemperature_HandleTypeDef* dt)
+{
+	return dt->converting;
+}
+
+// returns true once after DT_Service stored new samples
+bool DT_HasNewData(DallasTemperature_HandleTypeDef* dt)
+{
+	bool newData = dt->newData;
+	dt->newData = false;
+	return newData;
+}
+
+// returns the last sample DT_Service stored for a device index in 1/128
+// degrees C, or DEVICE_DISCONNECTED_RAW
+int16_t DT_GetSampleRaw(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex)
+{
+	if (deviceIndex >= dt->devices)
+		return DEVICE_DISCONNECTED_RAW;
+
+	return dt->device[deviceIndex].raw;
+}
+
+// returns the DT_STATUS_... flags of the last sample of a device index
+uint8_t DT_GetSampleStatus(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex)
+{
+	if (deviceIndex >= dt->devices)
+		return DT_STATUS_DISCONNECTED;
+
+	return dt->device[deviceIndex].status;
+}
+
+// returns true while DT_Service has not yet read a device index for the
+// running conversion. once false its sample is from this conversion, even
+// if slower devices are still pending
+bool DT_IsSamplePending(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex)
+{
+	if (deviceIndex >= dt->devices)
+		return false;
+
+	return dt->converting && dt->device[deviceIndex].pending;
+}
+
+// Sends command to one device to save values from scratchpad to EEPROM by index
+// Returns true if no errors were encountered, false indicates failure
+bool DT_SaveScratchPadByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex)
+{
+	CurrentDeviceAddress deviceAddress;
+  if (!DT_GetAddress(dt, deviceAddress, deviceIndex)) return false;
+
+  return DT_SaveScratchPad(dt, deviceAddress);
+}
+
+// Sends command to one or more devices to save values from scratchpad to EEPROM
+// If optional argument deviceAddress is omitted the command is send to all devices
+// Returns true if no errors were encountered, false indicates failure
+bool DT_SaveScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	uint8_t query[10]={0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	uint8_t b;
+
+#if REQUIRESALARMS
+  // the EEPROM gets the TH/TL set for the devices, not their windows
+  RestoreWindows(dt, deviceAddress);
+#endif
+
+  if (deviceAddress == NULL)
+  {
+	  query[0] = 0xCC;
+	  query[1] = COPYSCRATCH;
+	  b = OW_Send(dt->ow, OW_SEND_RESET, query, 2, NULL, 0, OW_NO_READ);
+  }
+  else
+  {
+	  query[0] = 0x55;
+	  memcpy(&query[1], deviceAddress, 8);
+	  query[9] = COPYSCRATCH;
+	  b = SendAddressed(dt, NULL, query, 10, NULL, 0, OW_NO_READ);
+  }
+
+  if (b != OW_OK)
+	  return false;
+
+  // Specification: NV Write Cycle Time is typically 2ms, max 10ms
+  // Waiting 20ms to allow for sensors that take longer in practice
+  if (!dt->parasite)
+  {
+    HAL_Delay(20);
+  }
+  else
+  {
+
+	ActivateExternalPullup(dt);
+    HAL_Delay(20);
+    DeactivateExternalPullup(dt);
+  }
+
+  return true;
+}
+
+// Sends command to one device to recall values from EEPROM to scratchpad by index
+// Returns true if no errors were encountered, false indicates failure
+bool DT_RecallScratchPadByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex)
+{
+  CurrentDeviceAddress deviceAddress;
+  if (!DT_GetAddress(dt, deviceAddress, deviceIndex)) return false;
+
+  return DT_RecallScratchPad(dt, deviceAddress);
+}
+
+// Sends command to one or more devices to recall values from EEPROM to scratchpad
+// If optional argument deviceAddress is omitted the command is send to all devices
+// Returns true if no errors were encountered, false indicates failure
+bool DT_RecallScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	uint8_t query[10]={0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	uint8_t b;
+
+	if (deviceAddress == NULL)
+	{
+	  query[0] = 0xCC;
+	  query[1] = RECALLSCRATCH;
+	  b = OW_Send(dt->ow, OW_SEND_RESET, query, 2, NULL, 0, OW_NO_READ);
+	}
+	else
+	{
+	  query[0] = 0x55;
+	  memcpy(&query[1], deviceAddress, 8);
+	  query[9] = RECALLSCRATCH;
+	  b = SendAddressed(dt, NULL, query, 10, NULL, 0, OW_NO_READ);
+	}
+
+	if (b != OW_OK)
+		return false;
+
+	// the scratchpad now holds the EEPROM values
+	DT_InvalidateConfig(dt, deviceAddress);
+
+	// Specification: Strong pullup only needed when writing to EEPROM (and temp conversion)
+	uint32_t start = HAL_GetTick();
+
+	while (dt->ow->huart->gState == HAL_UART_STATE_TIMEOUT)
+	{
+		// Datasheet doesn't specify typical/max duration, testing reveals typically within 1ms
+		if (HAL_GetTick() - start > 20) return false;
+		__NOP();
+	}
+
+	return true;
+}
+
+// Sets the autoSaveScratchPad flag
+void DT_SetAutoSaveScratchPad(DallasTemperature_HandleTypeDef* dt, bool flag)
+{
+  dt->autoSaveScratchPad = flag;
+}
+
+// Gets the autoSaveScratchPad flag
+bool DT_GetAutoSaveScratchPad(DallasTemperature_HandleTypeDef* dt)
+{
+  return dt->autoSaveScratchPad;
+}
+
+// Sets the writeBack flag
+// TRUE : TH, TL and resolution changes of devices in the table only update
+//        the shadow, DT_FlushConfig writes them to the devices later
+// FALSE: every change is written at once (the default)
+// the conversion timing follows the device, so a new resolution takes
+// effect once it is flushed
+void DT_SetWriteBack(DallasTemperature_HandleTypeDef* dt, bool flag)
+{
+  dt->writeBack = flag;
+}
+
+// Gets the writeBack flag
+bool DT_GetWriteBack(DallasTemperature_HandleTypeDef* dt)
+{
+  return dt->writeBack;
+}
+
+// Sets the sensorSearch flag
+// TRUE : DT_Begin, DT_Rescan and DT_UpdateDevices search only the families
+//        of temperature sensors, one targeted search each, so other devices
+//        on the bus do not cost search time and stay out of the table
+// FALSE: search all devices (the default)
+void DT_SetSensorSearch(DallasTemperature_HandleTypeDef* dt, bool flag)
+{
+  dt->sensorSearch = flag;
+}
+
+// Gets the sensorSearch flag
+bool DT_GetSensorSearch(DallasTemperature_HandleTypeDef* dt)
+{
+  return dt->sensorSearch;
+}
+
+// Sets the skipRomSingle flag
+// TRUE : while the last DT_Begin/DT_Rescan/DT_UpdateDevices searched all
+//        families, went through and found exactly one device, commands to
+//        that device use Skip ROM instead of Match ROM (the default)
+// FALSE: always Match ROM, e.g. if devices may be added without a rescan
+void DT_SetSkipRomSingle(DallasTemperature_HandleTypeDef* dt, bool flag)
+{
+  dt->skipRomSingle = flag;
+}
+
+// Gets the skipRomSingle flag
+bool DT_GetSkipRomSingle(DallasTemperature_HandleTypeDef* dt)
+{
+  return dt->skipRomSingle;
+}
+
+// Sets the number of temperature only reads between two full reads
+// 0: every temperature read clocks the whole scratchpad and checks its CRC
+//    (the default)
+// N: temperature reads of devices in the table read just the two
+//    temperature bytes, 16 instead of 72 data slots, checked for
+//    plausibility only. After N of them, or when a value is implausible,
+//    a full CRC checked read is done. DS1820/DS18S20 always read in full,
+//    and so does a device at exactly -0.0625 C, which reads as all ones
+//    like a device that did not answer
+void DT_SetFastRead(DallasTemperature_HandleTypeDef* dt, uint8_t interval)
+{
+  dt->fastReadInterval = interval;
+}
+
+// Gets the number of temperature only reads between two full reads
+uint8_t DT_GetFastRead(DallasTemperature_HandleTypeDef* dt)
+{
+  return dt->fastReadInterval;
+}
+
+// Writes the scratchpads of all devices with changes held back by write-back
+// mode. With autoSaveScratchPad they are then stored by a single Copy
+// Scratchpad, addressed if only one device changed, broadcast otherwise.
+// flushed (may be NULL) gets the indexes of the devices written, at most
+// 'count' of them.
+// Returns the number of devices written
+uint16_t DT_FlushConfig(DallasTemperature_HandleTypeDef* dt, uint16_t* flushed, uint16_t count)
+{
+	uint16_t written = 0;
+	uint16_t last = 0;
+
+	for (uint16_t i = 0; i < dt->devices; i++)
+	{
+		DallasTemperature_DeviceTypeDef* device = &dt->device[i];
+		ScratchPad scratchPad;
+
+		if (!device->configDirty)
+			continue;
+
+		scratchPad[HIGH_ALARM_TEMP] = device->highAlarm;
+		scratchPad[LOW_ALARM_TEMP] = device->lowAlarm;
+		scratchPad[CONFIGURATION] = device->config;
+
+		// keep the change for the next flush if nobody answered
+		device->configDirty = false;
+		if (!WriteScratchPadRam(dt, device->address, scratchPad))
+		{
+			device->configDirty = true;
+			continue;
+		}
+
+		if (flushed != NULL && written < count)
+			flushed[written] = i;
+
+		written++;
+		last = i;
+	}
+
+	if (written != 0 && dt->autoSaveScratchPad)
+		DT_SaveScratchPad(dt, (written == 1) ? dt->device[last].address : NULL);
+
+	// the devices convert at their new resolution from now on
+	if (written != 0 && TableResolution(dt) != 0)
+		dt->bitResolution = TableResolution(dt);
+
+	return written;
+}
+
+// Fetch temperature for device index
+float DT_GetTempCByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex)
+{
+	CurrentDeviceAddress deviceAddress;
+
+	if (!DT_GetAddress(dt, deviceAddress, deviceIndex))
+	{
+		return DEVICE_DISCONNECTED_C;
+	}
+
+	return DT_GetTempC(dt, (uint8_t*) deviceAddress);
+}
+
+// Fetch temperature for device index
+float DT_GetTempFByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex)
+{
+	CurrentDeviceAddress deviceAddress;
+
+	if (!DT_GetAddress(dt, deviceAddress, deviceIndex))
+	{
+		return DEVICE_DISCONNECTED_F;
+	}
+
+	return DT_GetTempF(dt, (uint8_t*) deviceAddress);
+}
+
+// reads scratchpad and returns fixed-point temperature, scaling factor 2^-7
+int16_t DT_CalculateTemperature(const uint8_t* deviceAddress, uint8_t* scratchPad)
+{
+	int16_t fpTemperature = (((int16_t) scratchPad[TEMP_MSB]) << 11) | (((int16_t) scratchPad[TEMP_LSB]) << 3);
+
+	/*
+	 DS1820 and DS18S20 have a 9-bit temperature register.
+
+	 Resolutions greater than 9-bit can be calculated using the data from
+	 the temperature, and COUNT REMAIN and COUNT PER °C registers in the
+	 scratchpad.  The resolution of the calculation depends on the model.
+
+	 While the COUNT PER °C register is hard-wired to 16 (10h) in a
+	 DS18S20, it changes with temperature in DS1820.
+
+	 After reading the scratchpad, the TEMP_READ value is obtained by
+	 truncating the 0.5°C bit (bit 0) from the temperature data. The
+	 extended resolution temperature can then be calculated using the
+	 following equation:
+
+	 COUNT_PER_C - COUNT_REMAIN
+	 TEMPERATURE = TEMP_READ - 0.25 + --------------------------
+	 COUNT_PER_C
+
+	 Hagai Shatz simplified this to integer arithmetic for a 12 bits
+	 value for a DS18S20, and James Cameron added legacy DS1820 support.
+
+	 See - http://myarduinotoy.blogspot.co.uk/2013/02/12bit-result-from-ds18s20.html
+	 */
+
+	if (deviceAddress[0] == DS18S20MODEL)
+	{
+		fpTemperature = ((fpTemperature & 0xfff0) << 3) - 16 + (((scratchPad[COUNT_PER_C] - scratchPad[COUNT_REMAIN]) << 7) / scratchPad[COUNT_PER_C]);
+	}
+
+	return fpTemperature;
+}
+
+// returns temperature in 1/128 degrees C or DEVICE_DISCONNECTED_RAW if the
+// device's scratch pad cannot be read successfully.
+// the numeric value of DEVICE_DISCONNECTED_RAW is defined in
+// DallasTemperature.h. It is a large negative number outside the
+// operating range of the device
+int16_t DT_GetTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	DallasTemperature_DeviceTypeDef* device = FindDevice(dt, deviceAddress);
+	int16_t raw;
+
+	if (device != NULL && FastReadRaw(dt, device, &raw))
+		return raw;
+
+	ScratchPad scratchPad;
+	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
+		return DT_CalculateTemperature(deviceAddress, scratchPad);
+	return DEVICE_DISCONNECTED_RAW;
+}
+
+// reads the temperature of every device found by DT_Begin/DT_Rescan
+// in one pass over the bus.
+// raw[i] gets the temperature of device index i in 1/128 degrees C, or
+// DEVICE_DISCONNECTED_RAW; status[i] (status may be NULL) gets its
+// DT_STATUS_... flags. Both arrays must hold 'count' entries, at most
+// DT_GetDeviceCount() entries are filled.
+// returns the number of devices read successfully
+uint16_t DT_ReadAllRaw(DallasTemperature_HandleTypeDef* dt, int16_t* raw, uint8_t* status, uint16_t count)
+{
+	// one query serves the whole sweep, only the address changes
+	uint8_t query[19]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, READSCRATCH, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+	bool present = true;
+	uint16_t good = 0;
+
+	if (count > dt->devices)
+		count = dt->devices;
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		uint8_t result = ReadDeviceRaw(dt, query, i, &raw[i], &present);
+
+		if (result == DT_STATUS_OK)
+			good++;
+
+		if (status != NULL)
+			status[i] = result;
+	}
+
+	return good;
+}
+
+// returns temperature in degrees C or DEVICE_DISCONNECTED_C if the
+// device's scratch pad cannot be read successfully.
+// the numeric value of DEVICE_DISCONNECTED_C is defined in
+// DallasTemperature.h. It is a large negative number outside the
+// operating range of the device
+float DT_GetTempC(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	return DT_RawToCelsius(DT_GetTemp(dt, deviceAddress));
+}
+
+// returns temperature in degrees F or DEVICE_DISCONNECTED_F if the
+// device's scratch pad cannot be read successfully.
+// the numeric value of DEVICE_DISCONNECTED_F is defined in
+// DallasTemperature.h. It is a large negative number outside the
+// operating range of the device
+float DT_GetTempF(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	return DT_RawToFahrenheit(DT_GetTemp(dt, deviceAddress));
+}
+
+// returns true if the bus requires parasite power
+bool DT_IsParasitePowerMode(DallasTemperature_HandleTypeDef* dt)
+{
+	return dt->parasite;
+}
+
+// IF alarm is not used one can store a 16 bit int of userdata in the alarm
+// registers. E.g. an ID of the sensor.
+// See github issue #29
+
+// note if device is not connected it will fail writing the data.
+void DT_SetUserData(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, int16_t data)
+{
+	ScratchPad scratchPad;
+	if (ReadConfig(dt, deviceAddress, scratchPad))
+	{
+		// return when stored value == new value
+		if ((int16_t) ((scratchPad[HIGH_ALARM_TEMP] << 8) | scratchPad[LOW_ALARM_TEMP]) == data)
+			return;
+
+		scratchPad[HIGH_ALARM_TEMP] = data >> 8;
+		scratchPad[LOW_ALARM_TEMP] = data & 255;
+		DT_WriteScratchPad(dt, deviceAddress, scratchPad);
+	}
+}
+
+int16_t DT_GetUserData(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	int16_t data = 0;
+	ScratchPad scratchPad;
+	if (ReadConfig(dt, deviceAddress, scratchPad))
+	{
+		data = scratchPad[HIGH_ALARM_TEMP] << 8;
+		data += scratchPad[LOW_ALARM_TEMP];
+	}
+	return data;
+}
+
+// note If address cannot be found no error will be reported.
+int16_t DT_GetUserDataByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex)
+{
+	CurrentDeviceAddress deviceAddress;
+	DT_GetAddress(dt, deviceAddress, deviceIndex);
+	return DT_GetUserData(dt, (uint8_t*) deviceAddress);
+}
+
+void DT_SetUserDataByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex, int16_t data)
+{
+	CurrentDeviceAddress deviceAddress;
+	DT_GetAddress(dt, deviceAddress, deviceIndex);
+	DT_SetUserData(dt, (uint8_t*) deviceAddress, data);
+}
+
+// Convert float Celsius to Fahrenheit
+float DT_ToFahrenheit(float celsius)
+{
+	return (celsius * 1.8) + 32;
+}
+
+// Convert float Fahrenheit to Celsius
+float DT_ToCelsius(float fahrenheit)
+{
+	return (fahrenheit - 32) * 0.555555556;
+}
+
+// convert from raw to Celsius
+float DT_RawToCelsius(int16_t raw)
+{
+	if (raw <= DEVICE_DISCONNECTED_RAW)
+		return DEVICE_DISCONNECTED_C;
+	// C = RAW/128
+	return (float) raw * 0.0078125;
+}
+
+// convert from raw to Fahrenheit
+float DT_RawToFahrenheit(int16_t raw)
+{
+	if (raw <= DEVICE_DISCONNECTED_RAW)
+		return DEVICE_DISCONNECTED_F;
+	// C = RAW/128
+	// F = (C*1.8)+32 = (RAW/128*1.8)+32 = (RAW*0.0140625)+32
+	return ((float) raw * 0.0140625) + 32;
+}
+
+#if REQUIRESALARMS
+/*
+
+ ALARMS:
+
+ TH and TL Register Format
+
+ BIT 7 BIT 6 BIT 5 BIT 4 BIT 3 BIT 2 BIT 1 BIT 0
+ S    2^6   2^5   2^4   2^3   2^2   2^1   2^0
+
+ Only bits 11 through 4 of the temperature register are used
+ in the TH and TL comparison since TH and TL are 8-bit
+ registers. If the measured temperature is lower than or equal
+ to TL or higher than or equal to TH, an alarm condition exists
+ and an alarm flag is set inside the DS18B20. This flag is
+ updated after every temperature measurement; therefore, if the
+ alarm condition goes away, the flag will be turned off after
+ the next temperature conversion.
+
+ */
+
+// sets the high alarm temperature for a device in degrees Celsius
+// accepts a float, but the alarm resolution will ignore anything
+// after a decimal point.  valid range is -55C - 125C
+void DT_SetHighAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, int8_t celsius)
+{
+	// make sure the alarm temperature is within the device's range
+	if (celsius > 125)
+		celsius = 125;
+	else if (celsius < -55)
+		celsius = -55;
+
+	ScratchPad scratchPad;
+	if (ReadConfig(dt, deviceAddress, scratchPad))
+	{
+		// return when stored value == new value
+		if ((int8_t) scratchPad[HIGH_ALARM_TEMP] == celsius)
+			return;
+
+		scratchPad[HIGH_ALARM_TEMP] = (uint8_t) celsius;
+		DT_WriteScratchPad(dt, deviceAddress, scratchPad);
+	}
+}
+
+// sets the low alarm temperature for a device in degrees Celsius
+// accepts a float, but the alarm resolution will ignore anything
+// after a decimal point.  valid range is -55C - 125C
+void DT_SetLowAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, int8_t celsius)
+{
+	// make sure the alarm temperature is within the device's range
+	if (celsius > 125)
+		celsius = 125;
+	else if (celsius < -55)
+		celsius = -55;
+
+	ScratchPad scratchPad;
+	if (ReadConfig(dt, deviceAddress, scratchPad))
+	{
+		// return when stored value == new value
+		if ((int8_t) scratchPad[LOW_ALARM_TEMP] == celsius)
+			return;
+
+		scratchPad[LOW_ALARM_TEMP] = (uint8_t) celsius;
+		DT_WriteScratchPad(dt, deviceAddress, scratchPad);
+	}
+}
+
+// returns a int8_t with the current high alarm temperature or
+// DEVICE_DISCONNECTED for an address
+int8_t DT_GetHighAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	ScratchPad scratchPad;
+	if (ReadConfig(dt, deviceAddress, scratchPad))
+		return (int8_t) scratchPad[HIGH_ALARM_TEMP];
+	return DEVICE_DISCONNECTED_C;
+}
+
+// returns a int8_t with the current low alarm temperature or
+// DEVICE_DISCONNECTED for an address
+int8_t DT_GetLowAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	ScratchPad scratchPad;
+	if (ReadConfig(dt, deviceAddress, scratchPad))
+		return (int8_t) scratchPad[LOW_ALARM_TEMP];
+	return DEVICE_DISCONNECTED_C;
+}
+
+// resets internal variables used for the alarm search.
+// the alarm search shares the search state of the OneWire handle with
+// DT_UpdateDevicesStep, it finds nothing while an update is in progress
+void DT_ResetAlarmSearch(DallasTemperature_HandleTypeDef* dt)
+{
+	if (dt->updating)
+		return;
+
+	OW_ResetAlarmSearch(dt->ow);
+}
+
+// Perform an alarm search: the search of the OneWire handle with the
+// Conditional Search command, so only devices whose last conversion was
+// at or beyond TH or TL answer. If this function returns true it has
+// enumerated the next such device and copied its address to newAddr.
+// If there are no devices, no further devices, or something horrible
+// happens in the middle of the enumeration false is returned.  Use
+// DT_ResetAlarmSearch() to start over.  Other commands may be sent
+// between two calls, only another search of the same handle disturbs it.
+bool DT_AlarmSearch(DallasTemperature_HandleTypeDef* dt, uint8_t* newAddr)
+{
+	if (dt->updating)
+		return false;
+
+	return OW_SearchNext(dt->ow, newAddr);
+}
+
+// returns true if device address might have an alarm condition
+// (only an alarm search can verify this)
+bool DT_HasAlarmByAddress(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	ScratchPad scratchPad;
+
+	if (DT_IsConnected_ScratchPad(dt, deviceAddress, scratchPad))
+	{
+		int8_t temp = DT_CalculateTemperature(deviceAddress, scratchPad) >> 7;
+
+		// check low alarm
+		if (temp <= (int8_t) scratchPad[LOW_ALARM_TEMP])
+			return true;
+
+		// check high alarm
+		if (temp >= (int8_t) scratchPad[HIGH_ALARM_TEMP])
+			return true;
+	}
+
+	// no alarm
+	return false;
+
+}
+
+// returns true if any device is reporting an alarm condition on the bus
+bool DT_HasAlarm(DallasTemperature_HandleTypeDef* dt)
+{
+	CurrentDeviceAddress deviceAddress;
+	DT_ResetAlarmSearch(dt);
+	return DT_AlarmSearch(dt, deviceAddress);
+}
+
+// runs the alarm handler for all devices returned by alarmSearch()
+// unless there no _AlarmHandler exist.
+void DT_ProcessAlarms(DallasTemperature_HandleTypeDef* dt)
+{
+	if (!DT_HasAlarmHandler(dt))
+	{
+		return;
+	}
+
+	DT_ResetAlarmSearch(dt);
+	CurrentDeviceAddress alarmAddr;
+
+	while (DT_AlarmSearch(dt, alarmAddr))
+	{
+		if (DT_ValidAddress(alarmAddr))
+		{
+			dt->_AlarmHandler(alarmAddr);
+		}
+	}
+}
+
+// starts a conversion on all devices, waits for it and reads only the
+// devices of the table that come up in the alarm search afterwards, so a
+// bus of N sensors with k alarms costs k scratchpad reads instead of N.
+// The samples are stored as DT_Service does (DT_GetSampleRaw/...Status)
+// and the alarm handler, if set, runs for every alarmed device read.
+// Does nothing while DT_UpdateDevicesStep is in progress.
+// returns the number of alarmed devices read
+uint16_t DT_ConvertAndProcessAlarms(DallasTemperature_HandleTypeDef* dt)
+{
+	uint8_t query[19]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, READSCRATCH, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+	CurrentDeviceAddress alarmAddr;
+	uint16_t alarms = 0;
+	bool present = true;
+
+	if (dt->updating)
+		return 0;
+
+	// the alarm flags are only valid once the conversion is done
+	OW_Send(dt->ow, OW_SEND_RESET, (uint8_t *) "\xcc\x44", 2, (uint8_t *) NULL, 0, OW_NO_READ);
+	BlockTillConversionComplete(dt, dt->bitResolution);
+	dt->converting = false;
+
+	DT_ResetAlarmSearch(dt);
+
+	// every search step starts with a reset, so the read can go between
+	while (DT_AlarmSearch(dt, alarmAddr))
+	{
+		DallasTemperature_DeviceTypeDef* device = FindDevice(dt, alarmAddr);
+
+		if (device == NULL || !DT_ValidFamily(alarmAddr))
+			continue;
+
+		device->status = ReadDeviceRaw(dt, query, (uint16_t) (device - dt->device), &device->raw, &present);
+		dt->newData = true;
+		alarms++;
+
+		if (DT_HasAlarmHandler(dt))
+			dt->_AlarmHandler(alarmAddr);
+	}
+
+	return alarms;
+}
+
+// Sets the change detection deadband in degrees C
+// 0: off, DT_ConvertAndReadChanged reads every device (the default). The
+//    TH/TL set for the devices are written back over their windows
+// N: after every sample TH/TL of the device are moved to N degrees above
+//    and below it, in the scratchpad RAM only, so the next conversion
+//    raises the alarm flag only if the sample moved by N degrees or more.
+//    The windows of all devices are set again by the next cycle.
+// The shadow and DT_GetHigh/LowAlarmTemp keep the TH/TL set for a device,
+// every write of the library replaces the window and DT_SaveScratchPad
+// puts the TH/TL back before the Copy Scratchpad, so a window never gets
+// into the EEPROM
+void DT_SetChangeDetection(DallasTemperature_HandleTypeDef* dt, uint8_t deadband)
+{
+	dt->changeDeadband = deadband;
+
+	for (uint16_t i = 0; i < dt->devices; i++)
+		dt->device[i].inWindow = false;
+
+	if (deadband == 0)
+		RestoreWindows(dt, NULL);
+}
+
+// Gets the change detection deadband
+uint8_t DT_GetChangeDetection(DallasTemperature_HandleTypeDef* dt)
+{
+	return dt->changeDeadband;
+}
+
+// reads a device for DT_ConvertAndReadChanged and moves its TH/TL
+// window to the new sample
+static bool ReadChanged(DallasTemperature_HandleTypeDef* dt, uint8_t* query, DallasTemperature_DeviceTypeDef* device, bool* present)
+{
+	ScratchPad scratchPad;
+
+	device->status = ReadDeviceRaw(dt, query, (uint16_t) (device - dt->device), &device->raw, present);
+	dt->newData = true;
+	device->inWindow = false;
+
+	if (device->status != DT_STATUS_OK)
+		return false;
+
+	// with changes held back by write-back mode the shadow is not what
+	// the device holds, it is read every cycle until they are flushed
+	if (dt->changeDeadband == 0 || device->configDirty || !ReadConfig(dt, device->address, scratchPad))
+		return true;
+
+	device->savedHigh = scratchPad[HIGH_ALARM_TEMP];
+	device->savedLow = scratchPad[LOW_ALARM_TEMP];
+	device->savedConfig = scratchPad[CONFIGURATION];
+
+	// the device compares the whole degrees of the sample with TH and TL
+	int16_t celsius = device->raw >> 7;
+	scratchPad[HIGH_ALARM_TEMP] = (uint8_t) constrain(celsius + dt->changeDeadband, -55, 125);
+	scratchPad[LOW_ALARM_TEMP] = (uint8_t) constrain(celsius - dt->changeDeadband, -55, 125);
+
+	// RAM only, the EEPROM must not wear out on every change. a failed
+	// write may still have changed TH/TL, so they are restored either way
+	device->windowed = true;
+	device->inWindow = SendScratchPad(dt, device->address, scratchPad);
+
+	return true;
+}
+
+// writes the TH, TL and configuration a change detection window replaced
+// back to the scratchpad of a device, or of all devices if deviceAddress
+// is NULL
+static void RestoreWindows(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress)
+{
+	for (uint16_t i = 0; i < dt->devices; i++)
+	{
+		DallasTemperature_DeviceTypeDef* device = &dt->device[i];
+		ScratchPad scratchPad;
+
+		if (!device->windowed || (deviceAddress != NULL && memcmp(device->address, deviceAddress, 8) != 0))
+			continue;
+
+		scratchPad[HIGH_ALARM_TEMP] = device->savedHigh;
+		scratchPad[LOW_ALARM_TEMP] = device->savedLow;
+		scratchPad[CONFIGURATION] = device->savedConfig;
+
+		if (SendScratchPad(dt, device->address, scratchPad))
+		{
+			device->windowed = false;
+			device->inWindow = false;
+		}
+	}
+}
+
+// starts a conversion on all devices, waits for it and reads only the
+// devices whose sample left the window DT_SetChangeDetection keeps in their
+// TH/TL, found with the alarm search, plus the devices without a window
+// yet. Every device read gets its window moved to the new sample. The
+// samples are stored as DT_Service does (DT_GetSampleRaw/...Status).
+// The alarm search sees every flag, so this does not mix with TH/TL
+// used as real alarms. Does nothing while DT_UpdateDevicesStep is in
+// progress.
+// returns the number of devices read
+uint16_t DT_ConvertAndReadChanged(DallasTemperature_HandleTypeDef* dt)
+{
+	uint8_t query[19]={0x55, 0, 0, 0, 0, 0, 0, 0, 0, READSCRATCH, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+	CurrentDeviceAddress alarmAddr;
+	uint16_t read = 0;
+	bool present = true;
+	bool windows = false;
+
+	if (dt->updating)
+		return 0;
+
+	OW_Send(dt->ow, OW_SEND_RESET, (uint8_t *) "\xcc\x44", 2, (uint8_t *) NULL, 0, OW_NO_READ);
+	BlockTillConversionComplete(dt, dt->bitResolution);
+	dt->converting = false;
+
+	// on the first cycle the search would only find devices read anyway
+	for (uint16_t i = 0; i < dt->devices && !windows; i++)
+		windows = dt->device[i].inWindow;
+
+	if (dt->changeDeadband != 0 && windows)
+	{
+		DT_ResetAlarmSearch(dt);
+
+		// every search step starts with a reset, so the reads and window
+		// writes can go between
+		while (DT_AlarmSearch(dt, alarmAddr))
+		{
+			DallasTemperature_DeviceTypeDef* device = FindDevice(dt, alarmAddr);
+
+			// devices without a window yet raise the flag on their
+			// old TH/TL, they are read below anyway
+			if (device == NULL || !device->inWindow || !DT_ValidFamily(alarmAddr))
+				continue;
+
+			if (ReadChanged(dt, query, device, &present))
+				read++;
+		}
+	}
+
+	for (uint16_t i = 0; i < dt->devices; i++)
+	{
+		DallasTemperature_DeviceTypeDef* device = &dt->device[i];
+
+		if (device->inWindow || !DT_ValidFamily(device->address))
+			continue;
+
+		if (ReadChanged(dt, query, device, &present))
+			read++;
+	}
+
+	return read;
+}
+
+// sets the alarm handler
+void DT_SetAlarmHandler(DallasTemperature_HandleTypeDef* dt, AlarmHandler *handler)
+{
+	dt->_AlarmHandler = handler;
+}
+
+// checks if AlarmHandler has been set.
+bool DT_HasAlarmHandler(DallasTemperature_HandleTypeDef* dt)
+{
+  return dt->_AlarmHandler != NO_ALARM_HANDLER;
+}
+
+#endif
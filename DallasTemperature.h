@@ -1,164 +1,296 @@
-/*
- * DallasTemperature.h
- *
- *  Created on: Dec 24, 2020
- *      Author: tabur
- */
-
-#ifndef INC_DALLASTEMPERATURE_H_
-#define INC_DALLASTEMPERATURE_H_
-
-// set to true to include code implementing alarm search functions
-#ifndef REQUIRESALARMS
-#define REQUIRESALARMS	false
-#endif
-
-#include "OneWire.h"
-
-// Model IDs
-#define DS18S20MODEL 	0x10  // also DS1820
-#define DS18B20MODEL 	0x28  // also MAX31820
-#define DS1822MODEL  	0x22
-#define DS1825MODEL  	0x3B
-#define DS28EA00MODEL 	0x42
-
-// Error Codes
-#define DEVICE_DISCONNECTED_C 	-127
-#define DEVICE_DISCONNECTED_F 	-196.6
-#define DEVICE_DISCONNECTED_RAW -7040
-
-#define max(a,b) (((a)>(b))?(a):(b))
-#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
-
-#define ONEWIRE_MAX_DEVICES	5
-
-#if REQUIRESALARMS
-typedef void AlarmHandler(const uint8_t*);
-// Alarm handler
-#define NO_ALARM_HANDLER ((AlarmHandler *)0)
-#endif
-
-typedef struct{
-	OneWire_HandleTypeDef* ow;
-	// count of devices on the bus
-	uint8_t devices;
-	// count of DS18xxx Family devices on bus
-	uint8_t ds18Count;
-	// parasite power on or off
-	bool parasite;
-	// external pullup
-	bool useExternalPullup;
-	// used to determine the delay amount needed to allow for the
-	// temperature conversion to take place
-	uint8_t bitResolution;
-	// used to requestTemperature with or without delay
-	bool waitForConversion;
-	// used to requestTemperature to dynamically check if a conversion is complete
-	bool checkForConversion;
-	// used to determine if values will be saved from scratchpad to EEPROM on every scratchpad write
-	bool autoSaveScratchPad;
-#if REQUIRESALARMS
-	// required for alarmSearch
-	uint8_t alarmSearchAddress[8];
-	int8_t alarmSearchJunction;
-	uint8_t alarmSearchExhausted;
-	// the alarm handler function pointer
-	AlarmHandler *_AlarmHandler;
-#endif
-}DallasTemperature_HandleTypeDef;
-
-typedef uint8_t ScratchPad[9];
-typedef uint8_t AllDeviceAddress[8 * ONEWIRE_MAX_DEVICES];
-typedef uint8_t CurrentDeviceAddress[8];
-
-// initialise bus
-void DT_SetOneWire(DallasTemperature_HandleTypeDef* dt, OneWire_HandleTypeDef* ow);
-void DT_Begin(DallasTemperature_HandleTypeDef* dt);
-uint8_t DT_GetDeviceCount(DallasTemperature_HandleTypeDef* dt);
-uint8_t DT_GetDS18Count(DallasTemperature_HandleTypeDef* dt);
-bool DT_ValidAddress(const uint8_t* deviceAddress);
-bool DT_ValidFamily(const uint8_t* deviceAddress);
-bool DT_GetAddress(DallasTemperature_HandleTypeDef* dt, uint8_t* currentDeviceAddress, uint8_t index);
-bool DT_IsConnected(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-bool DT_IsConnected_ScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t* scratchPad);
-bool DT_ReadScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t* scratchPad);
-void DT_WriteScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, const uint8_t* scratchPad);
-bool DT_ReadPowerSupply(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-void DT_SetAllResolution(DallasTemperature_HandleTypeDef* dt, uint8_t newResolution);
-bool DT_SetResolution(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t newResolution, bool skipGlobalBitResolutionCalculation);
-uint8_t DT_GetAllResolution(DallasTemperature_HandleTypeDef* dt);
-uint8_t DT_GetResolution(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-void DT_SetWaitForConversion(DallasTemperature_HandleTypeDef* dt, bool flag);
-bool DT_GetWaitForConversion(DallasTemperature_HandleTypeDef* dt);
-void DT_SetCheckForConversion(DallasTemperature_HandleTypeDef* dt, bool flag);
-bool DT_GetCheckForConversion(DallasTemperature_HandleTypeDef* dt);
-bool DT_IsConversionComplete(DallasTemperature_HandleTypeDef* dt);
-void DT_RequestTemperatures(DallasTemperature_HandleTypeDef* dt);
-bool DT_RequestTemperaturesByAddress(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-bool DT_RequestTemperaturesByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex);
-int16_t DT_MillisToWaitForConversion(uint8_t bitResolution);
-bool DT_SaveScratchPadByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex);
-bool DT_SaveScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-bool DT_RecallScratchPadByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex);
-bool DT_RecallScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-void DT_SetAutoSaveScratchPad(DallasTemperature_HandleTypeDef* dt, bool flag);
-bool DT_GetAutoSaveScratchPad(DallasTemperature_HandleTypeDef* dt);
-uint8_t DT_GetAllResolution(DallasTemperature_HandleTypeDef* dt);
-uint8_t DT_GetResolution(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-float DT_GetTempCByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex);
-float DT_GetTempFByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex);
-int16_t DT_GetTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-float DT_GetTempC(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-float DT_GetTempF(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-int16_t DT_GetUserData(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-int16_t DT_GetUserDataByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex);
-void DT_SetUserDataByIndex(DallasTemperature_HandleTypeDef* dt, uint8_t deviceIndex, int16_t data);
-float DT_ToFahrenheit(float celsius);
-float DT_ToCelsius(float fahrenheit);
-float DT_RawToCelsius(int16_t raw);
-float DT_RawToFahrenheit(int16_t raw);
-bool DT_IsParasitePowerMode(DallasTemperature_HandleTypeDef* dt);
-void DT_SetPullupPin(DallasTemperature_HandleTypeDef* dt, GPIO_TypeDef* port, uint32_t pin);
-int16_t DT_CalculateTemperature(const uint8_t* deviceAddress, uint8_t* scratchPad);
-
-
-
-#if REQUIRESALARMS
-	// sets the high alarm temperature for a device
-	// accepts a int8_t.  valid range is -55C - 125C
-	void DT_SetHighAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, int8_t celsius);
-
-	// sets the low alarm temperature for a device
-	// accepts a int8_t.  valid range is -55C - 125C
-	void DT_SetLowAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, int8_t celsius);
-
-	// returns a int8_t with the current high alarm temperature for a device
-	// in the range -55C - 125C
-	int8_t DT_GetHighAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-
-	// returns a int8_t with the current low alarm temperature for a device
-	// in the range -55C - 125C
-	int8_t DT_GetLowAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-
-	// resets internal variables used for the alarm search
-	void DT_ResetAlarmSearch(DallasTemperature_HandleTypeDef* dt);
-
-	// search the wire for devices with active alarms
-	bool DT_AlarmSearch(DallasTemperature_HandleTypeDef* dt, uint8_t* newAddr);
-
-	// returns true if ia specific device has an alarm
-	bool DT_HasAlarm(DallasTemperature_HandleTypeDef* dt);
-	bool DT_HasAlarmByAddress(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
-
-	// runs the alarm handler for all devices returned by alarmSearch()
-	void DT_ProcessAlarms(DallasTemperature_HandleTypeDef* dt);
-
-	// sets the alarm handler
-	void DT_SetAlarmHandler(DallasTemperature_HandleTypeDef* dt, const AlarmHandler *);
-
-	// returns true if an AlarmHandler has been set
-	bool DT_HasAlarmHandler(DallasTemperature_HandleTypeDef* dt);
-
-#endif
-
-#endif /* INC_DALLASTEMPERATURE_H_ */
+/*
+ * DallasTemperature.h
+ *
+ *  Created on: Dec 24, 2020
+ *      Author: tabur
+ */
+
+#ifndef INC_DALLASTEMPERATURE_H_
+#define INC_DALLASTEMPERATURE_H_
+
+// set to true to include code implementing alarm search functions
+#ifndef REQUIRESALARMS
+#define REQUIRESALARMS	false
+#endif
+
+#include "OneWire.h"
+
+// Model IDs
+#define DS18S20MODEL 	0x10  // also DS1820
+#define DS18B20MODEL 	0x28  // also MAX31820
+#define DS1822MODEL  	0x22
+#define DS1825MODEL  	0x3B
+#define DS28EA00MODEL 	0x42
+
+// Error Codes
+#define DEVICE_DISCONNECTED_C 	-127
+#define DEVICE_DISCONNECTED_F 	-196.6
+#define DEVICE_DISCONNECTED_RAW -7040
+
+// Per device read status flags
+#define DT_STATUS_OK			0x00
+#define DT_STATUS_CRC_FAIL		0x01
+#define DT_STATUS_DISCONNECTED	0x02
+
+#define max(a,b) (((a)>(b))?(a):(b))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+// entries of the device table built into every handle. Larger buses can
+// hand a table of their own to DT_SetDeviceTable()
+#ifndef ONEWIRE_MAX_DEVICES
+#define ONEWIRE_MAX_DEVICES	5
+#endif
+
+// set to true to keep the Match ROM prefix (0x55 + ROM) of every device
+// found as ready to send bit slots, 72 bytes of RAM per device
+#ifndef DT_MATCH_ROM_FRAMES
+#define DT_MATCH_ROM_FRAMES	true
+#endif
+
+typedef void DeviceHandler(const uint8_t*);
+// Device added/removed handler
+#define NO_DEVICE_HANDLER ((DeviceHandler *)0)
+
+#if REQUIRESALARMS
+typedef void AlarmHandler(const uint8_t*);
+// Alarm handler
+#define NO_ALARM_HANDLER ((AlarmHandler *)0)
+#endif
+
+// what the library keeps about every device found on the bus
+typedef struct{
+	// ROM code
+	uint8_t address[8];
+	// last sample stored by DT_Service, in 1/128 degrees C
+	int16_t raw;
+	// DT_STATUS_... flags of that sample
+	uint8_t status;
+	// 9-12 as last read or written, 0 if unknown
+	uint8_t resolution;
+	// started conversion not read yet by DT_Service
+	bool pending;
+	// shadow of TH, TL and the configuration register, kept by every
+	// scratchpad read and write. only used while configValid is set
+	uint8_t highAlarm;
+	uint8_t lowAlarm;
+	uint8_t config;
+	bool configValid;
+	// shadow holds changes not written to the device yet (write-back mode)
+	bool configDirty;
+	// temperature only reads since the last CRC checked read
+	uint8_t fastReads;
+#if REQUIRESALARMS
+	// TH/TL of the device hold a change detection window instead of the
+	// saved TH, TL and configuration, which go back before a Copy Scratchpad
+	bool windowed;
+	uint8_t savedHigh;
+	uint8_t savedLow;
+	uint8_t savedConfig;
+	// the window is centred on the last sample
+	bool inWindow;
+#endif
+#if DT_MATCH_ROM_FRAMES
+	// 0x55 and the ROM code as bit slots, for OW_SendFrame
+	uint8_t matchRom[9 * 8];
+#endif
+}DallasTemperature_DeviceTypeDef;
+
+typedef struct{
+	OneWire_HandleTypeDef* ow;
+	// count of devices on the bus
+	uint16_t devices;
+	// devices found by the last DT_Begin or DT_Rescan, in search order.
+	// points to deviceStorage unless DT_SetDeviceTable() supplied another
+	// table of deviceCapacity entries
+	DallasTemperature_DeviceTypeDef* device;
+	uint16_t deviceCapacity;
+	// the last search found more devices than the table holds
+	bool deviceOverflow;
+	// the last search of all families went through and found one device
+	bool singleDevice;
+	DallasTemperature_DeviceTypeDef deviceStorage[ONEWIRE_MAX_DEVICES];
+	// count of DS18xxx Family devices on bus
+	uint16_t ds18Count;
+	// parasite power on or off
+	bool parasite;
+	// external pullup
+	bool useExternalPullup;
+	// used to determine the delay amount needed to allow for the
+	// temperature conversion to take place
+	uint8_t bitResolution;
+	// used to requestTemperature with or without delay
+	bool waitForConversion;
+	// used to requestTemperature to dynamically check if a conversion is complete
+	bool checkForConversion;
+	// used to determine if values will be saved from scratchpad to EEPROM on every scratchpad write
+	bool autoSaveScratchPad;
+	// used to hold scratchpad writes back in the shadow until DT_FlushConfig
+	bool writeBack;
+	// used to address the only device of a bus with Skip ROM
+	bool skipRomSingle;
+	// used to search only the families of temperature sensors
+	bool sensorSearch;
+	// temperature only reads between two CRC checked reads, 0 = off
+	uint8_t fastReadInterval;
+	// DT_StartConversion/DT_Service pipeline: conversion running, its start tick
+	// and whether DT_Service stored samples nobody has asked for yet
+	bool converting;
+	uint32_t conversionStart;
+	bool newData;
+	// ms after conversionStart of the last read slot poll
+	uint32_t conversionPoll;
+	// devices of the running conversion DT_Service has not read yet
+	uint16_t conversionPending;
+	// DT_UpdateDevicesStep in progress: next table entry to compare with
+	// the search and the changes made so far
+	bool updating;
+	uint16_t updateIndex;
+	uint16_t updateChanges;
+	// family searched by a sensorSearch update
+	uint8_t updatePass;
+	// called by DT_UpdateDevices/DT_CheckDevices for devices added or removed
+	DeviceHandler *_AddedHandler;
+	DeviceHandler *_RemovedHandler;
+#if REQUIRESALARMS
+	// the alarm handler function pointer
+	AlarmHandler *_AlarmHandler;
+	// degrees C a sample may move before DT_ConvertAndReadChanged reads
+	// it again, 0 = off
+	uint8_t changeDeadband;
+#endif
+}DallasTemperature_HandleTypeDef;
+
+typedef uint8_t ScratchPad[9];
+typedef uint8_t AllDeviceAddress[8 * ONEWIRE_MAX_DEVICES];
+typedef uint8_t CurrentDeviceAddress[8];
+
+// initialise bus
+void DT_SetOneWire(DallasTemperature_HandleTypeDef* dt, OneWire_HandleTypeDef* ow);
+void DT_SetDeviceTable(DallasTemperature_HandleTypeDef* dt, DallasTemperature_DeviceTypeDef* table, uint16_t capacity);
+void DT_Begin(DallasTemperature_HandleTypeDef* dt);
+uint16_t DT_Rescan(DallasTemperature_HandleTypeDef* dt);
+bool DT_GetDeviceOverflow(DallasTemperature_HandleTypeDef* dt);
+uint16_t DT_UpdateDevices(DallasTemperature_HandleTypeDef* dt);
+bool DT_UpdateDevicesStep(DallasTemperature_HandleTypeDef* dt, uint8_t maxTriplets, uint16_t* changes);
+uint16_t DT_CheckDevices(DallasTemperature_HandleTypeDef* dt, bool scratchPad);
+void DT_SetDeviceHandlers(DallasTemperature_HandleTypeDef* dt, DeviceHandler *added, DeviceHandler *removed);
+uint16_t DT_GetDeviceCount(DallasTemperature_HandleTypeDef* dt);
+uint16_t DT_GetDS18Count(DallasTemperature_HandleTypeDef* dt);
+bool DT_ValidAddress(const uint8_t* deviceAddress);
+bool DT_ValidFamily(const uint8_t* deviceAddress);
+bool DT_GetAddress(DallasTemperature_HandleTypeDef* dt, uint8_t* currentDeviceAddress, uint16_t index);
+bool DT_IsConnected(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+bool DT_IsConnected_ScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t* scratchPad);
+bool DT_ReadScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t* scratchPad);
+void DT_WriteScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, const uint8_t* scratchPad);
+bool DT_ReadPowerSupply(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+void DT_SetAllResolution(DallasTemperature_HandleTypeDef* dt, uint8_t newResolution);
+bool DT_ConfigureAll(DallasTemperature_HandleTypeDef* dt, int8_t highAlarm, int8_t lowAlarm, uint8_t newResolution, bool verify);
+void DT_InvalidateConfig(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+uint8_t DT_RefreshConfig(DallasTemperature_HandleTypeDef* dt);
+bool DT_SetResolution(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, uint8_t newResolution, bool skipGlobalBitResolutionCalculation);
+uint8_t DT_GetAllResolution(DallasTemperature_HandleTypeDef* dt);
+uint8_t DT_GetResolution(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+void DT_SetWaitForConversion(DallasTemperature_HandleTypeDef* dt, bool flag);
+bool DT_GetWaitForConversion(DallasTemperature_HandleTypeDef* dt);
+void DT_SetCheckForConversion(DallasTemperature_HandleTypeDef* dt, bool flag);
+bool DT_GetCheckForConversion(DallasTemperature_HandleTypeDef* dt);
+bool DT_IsConversionComplete(DallasTemperature_HandleTypeDef* dt);
+void DT_RequestTemperatures(DallasTemperature_HandleTypeDef* dt);
+bool DT_RequestTemperaturesByAddress(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+bool DT_RequestTemperaturesByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex);
+int16_t DT_MillisToWaitForConversion(uint8_t bitResolution);
+uint16_t DT_MillisBetweenConversionPolls(uint8_t bitResolution);
+bool DT_SaveScratchPadByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex);
+bool DT_SaveScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+bool DT_RecallScratchPadByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex);
+bool DT_RecallScratchPad(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+void DT_SetAutoSaveScratchPad(DallasTemperature_HandleTypeDef* dt, bool flag);
+bool DT_GetAutoSaveScratchPad(DallasTemperature_HandleTypeDef* dt);
+void DT_SetWriteBack(DallasTemperature_HandleTypeDef* dt, bool flag);
+bool DT_GetWriteBack(DallasTemperature_HandleTypeDef* dt);
+uint16_t DT_FlushConfig(DallasTemperature_HandleTypeDef* dt, uint16_t* flushed, uint16_t count);
+void DT_SetSkipRomSingle(DallasTemperature_HandleTypeDef* dt, bool flag);
+bool DT_GetSkipRomSingle(DallasTemperature_HandleTypeDef* dt);
+void DT_SetSensorSearch(DallasTemperature_HandleTypeDef* dt, bool flag);
+bool DT_GetSensorSearch(DallasTemperature_HandleTypeDef* dt);
+void DT_SetFastRead(DallasTemperature_HandleTypeDef* dt, uint8_t interval);
+uint8_t DT_GetFastRead(DallasTemperature_HandleTypeDef* dt);
+uint8_t DT_GetAllResolution(DallasTemperature_HandleTypeDef* dt);
+uint8_t DT_GetResolution(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+float DT_GetTempCByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex);
+float DT_GetTempFByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex);
+int16_t DT_GetTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+uint16_t DT_ReadAllRaw(DallasTemperature_HandleTypeDef* dt, int16_t* raw, uint8_t* status, uint16_t count);
+bool DT_StartConversion(DallasTemperature_HandleTypeDef* dt);
+bool DT_Service(DallasTemperature_HandleTypeDef* dt);
+bool DT_IsConverting(DallasTemperature_HandleTypeDef* dt);
+bool DT_HasNewData(DallasTemperature_HandleTypeDef* dt);
+int16_t DT_GetSampleRaw(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex);
+uint8_t DT_GetSampleStatus(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex);
+bool DT_IsSamplePending(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex);
+float DT_GetTempC(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+float DT_GetTempF(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+int16_t DT_GetUserData(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+int16_t DT_GetUserDataByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex);
+void DT_SetUserDataByIndex(DallasTemperature_HandleTypeDef* dt, uint16_t deviceIndex, int16_t data);
+float DT_ToFahrenheit(float celsius);
+float DT_ToCelsius(float fahrenheit);
+float DT_RawToCelsius(int16_t raw);
+float DT_RawToFahrenheit(int16_t raw);
+bool DT_IsParasitePowerMode(DallasTemperature_HandleTypeDef* dt);
+void DT_SetPullupPin(DallasTemperature_HandleTypeDef* dt, GPIO_TypeDef* port, uint32_t pin);
+int16_t DT_CalculateTemperature(const uint8_t* deviceAddress, uint8_t* scratchPad);
+
+
+
+#if REQUIRESALARMS
+	// sets the high alarm temperature for a device
+	// accepts a int8_t.  valid range is -55C - 125C
+	void DT_SetHighAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, int8_t celsius);
+
+	// sets the low alarm temperature for a device
+	// accepts a int8_t.  valid range is -55C - 125C
+	void DT_SetLowAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress, int8_t celsius);
+
+	// returns a int8_t with the current high alarm temperature for a device
+	// in the range -55C - 125C
+	int8_t DT_GetHighAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+
+	// returns a int8_t with the current low alarm temperature for a device
+	// in the range -55C - 125C
+	int8_t DT_GetLowAlarmTemp(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+
+	// resets internal variables used for the alarm search. The alarm
+	// search functions find nothing while DT_UpdateDevicesStep is running
+	void DT_ResetAlarmSearch(DallasTemperature_HandleTypeDef* dt);
+
+	// search the wire for devices with active alarms
+	bool DT_AlarmSearch(DallasTemperature_HandleTypeDef* dt, uint8_t* newAddr);
+
+	// returns true if ia specific device has an alarm
+	bool DT_HasAlarm(DallasTemperature_HandleTypeDef* dt);
+	bool DT_HasAlarmByAddress(DallasTemperature_HandleTypeDef* dt, const uint8_t* deviceAddress);
+
+	// runs the alarm handler for all devices returned by alarmSearch()
+	void DT_ProcessAlarms(DallasTemperature_HandleTypeDef* dt);
+
+	// converts, then reads and handles only the devices with an alarm
+	uint16_t DT_ConvertAndProcessAlarms(DallasTemperature_HandleTypeDef* dt);
+
+	// sets the TH/TL window used to detect changed samples, 0 = off
+	void DT_SetChangeDetection(DallasTemperature_HandleTypeDef* dt, uint8_t deadband);
+	uint8_t DT_GetChangeDetection(DallasTemperature_HandleTypeDef* dt);
+
+	// converts, then reads only the devices whose sample left its window
+	uint16_t DT_ConvertAndReadChanged(DallasTemperature_HandleTypeDef* dt);
+
+	// sets the alarm handler
+	void DT_SetAlarmHandler(DallasTemperature_HandleTypeDef* dt, AlarmHandler *);
+
+	// returns true if an AlarmHandler has been set
+	bool DT_HasAlarmHandler(DallasTemperature_HandleTypeDef* dt);
+
+#endif
+
+#endif /* INC_DALLASTEMPERATURE_H_ */
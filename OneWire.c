@@ -1,404 +1,1284 @@
-/*
- * OneWire.c
- *
- *  Created on: Dec 16, 2020
- *      Author: Andriy Honcharenko
- */
-#include "OneWire.h"
-
-static HAL_StatusTypeDef OW_UART_Init(OneWire_HandleTypeDef* ow, uint32_t baudRate);
-static void OW_ToBits(uint8_t owByte, uint8_t *owBits);
-static uint8_t OW_ToByte(uint8_t *owBits);
-
-#if ONEWIRE_SEARCH
-static void OW_SendBits(OneWire_HandleTypeDef* ow, uint8_t num_bits);
-#endif
-
-static HAL_StatusTypeDef OW_UART_Init(OneWire_HandleTypeDef* ow, uint32_t baudRate)
-{
-	UART_HandleTypeDef* HUARTx = ow->huart;
-
-	/*Configure GPIO pin : ONE_WIRE_Pin */
-//	GPIO_InitTypeDef GPIO_InitStruct = {0};
-//	GPIO_InitStruct.Pin = GPIO_PIN_10;
-//	GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
-//	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
-//	HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
-
-    HUARTx->Init.BaudRate = baudRate;
-    HUARTx->Init.WordLength = UART_WORDLENGTH_8B;
-    HUARTx->Init.StopBits = UART_STOPBITS_1;
-    HUARTx->Init.Parity = UART_PARITY_NONE;
-    HUARTx->Init.Mode = UART_MODE_TX_RX;
-    HUARTx->Init.HwFlowCtl = UART_HWCONTROL_NONE;
-    HUARTx->Init.OverSampling = UART_OVERSAMPLING_16;
-	return HAL_HalfDuplex_Init(HUARTx);
-}
-
-static void OW_ToBits(uint8_t owByte, uint8_t *owBits)
-{
-	uint8_t i;
-	for (i = 0; i < 8; i++)
-	{
-		if (owByte & 0x01)
-		{
-			*owBits = OW_1;
-		}
-		else
-		{
-			*owBits = OW_0;
-		}
-		owBits++;
-		owByte = owByte >> 1;
-	}
-}
-
-static uint8_t OW_ToByte(uint8_t *owBits)
-{
-	uint8_t owByte, i;
-	owByte = 0;
-	for (i = 0; i < 8; i++)
-	{
-		owByte = owByte >> 1;
-		if (*owBits == OW_R_1)
-		{
-			owByte |= 0x80;
-		}
-		owBits++;
-	}
-
-	return owByte;
-}
-
-HAL_StatusTypeDef OneWire(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart)
-{
-	return OW_Begin(ow, huart);
-}
-
-HAL_StatusTypeDef OW_Begin(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart)
-{
-	ow->huart = huart;
-	HAL_StatusTypeDef status = OW_UART_Init(ow, 9600);
-#if ONEWIRE_SEARCH
-	OW_ResetSearch(ow);
-#endif
-	return status;
-}
-
-// Perform the onewire reset function.  We will wait up to 250uS for
-// the bus to come high, if it doesn't then it is broken or shorted
-// and we return a 0;
-//
-// Returns 1 if a device asserted a presence pulse, 0 otherwise.
-//
-uint8_t OW_Reset(OneWire_HandleTypeDef* ow)
-{
-	uint8_t owPresence = 0xf0;
-
-	OW_UART_Init(ow, 9600);
-
-	HAL_UART_Receive_DMA(ow->huart, &owPresence, 1);
-	//HAL_UART_Transmit(ow->huart, &owPresence, 1, HAL_MAX_DELAY);
-	HAL_UART_Transmit_DMA(ow->huart, &owPresence, 1);
-
-	/*## Wait for the end of the transfer ###################################*/
-	while (HAL_UART_GetState(ow->huart) != HAL_UART_STATE_READY)
-	{
-		__NOP();
-	}
-
-	OW_UART_Init(ow, 115200);
-
-	if (owPresence != 0xf0)
-	{
-		return OW_OK;
-	}
-
-	return OW_NO_DEVICE;
-}
-
-//-----------------------------------------------------------------------------
-// procedure bus communication 1-wire
-// command - an array of bytes sent to the bus. If you need reading, we send OW_READ_SLOT
-// cLen - the length of the command buffer, as many bytes will be sent to the bus
-// data - if reading is required, then a reference to the buffer for reading
-// dLen - the length of the read buffer. Read no more than this length
-// readStart - which transmission character to start reading from (numbered from 0)
-// you can specify OW_NO_READ, then you don't need to specify data and dLen
-//-----------------------------------------------------------------------------
-uint8_t OW_Send(OneWire_HandleTypeDef* ow, uint8_t *command, uint8_t cLen, uint8_t *data, uint8_t dLen, uint8_t readStart)
-{
-	if (OW_Reset(ow) == OW_NO_DEVICE)
-	{
-		return OW_NO_DEVICE;
-	}
-
-	while (cLen > 0)
-	{
-
-		OW_ToBits(*command, ow->ROM_NO);
-		command++;
-		cLen--;
-
-		HAL_UART_Receive_DMA(ow->huart, ow->ROM_NO, sizeof(ow->ROM_NO) / sizeof(ow->ROM_NO[0]));
-		HAL_UART_Transmit_DMA(ow->huart, ow->ROM_NO, sizeof(ow->ROM_NO) / sizeof(ow->ROM_NO[0]));
-
-		while (HAL_UART_GetState(ow->huart) != HAL_UART_STATE_READY)
-		{
-			__NOP();
-		}
-
-		if (readStart == 0 && dLen > 0)
-		{
-			*data = OW_ToByte(ow->ROM_NO);
-			data++;
-			dLen--;
-		}
-		else
-		{
-			if (readStart != OW_NO_READ)
-			{
-				readStart--;
-			}
-		}
-	}
-
-	return OW_OK;
-}
-
-#if ONEWIRE_SEARCH
-static void OW_SendBits(OneWire_HandleTypeDef* ow, uint8_t numBits)
-{
-	HAL_UART_Receive_DMA(ow->huart, ow->ROM_NO, numBits);
-	HAL_UART_Transmit_DMA(ow->huart, ow->ROM_NO, numBits);
-
-	while (HAL_UART_GetState(ow->huart) != HAL_UART_STATE_READY)
-	{
-		__NOP();
-	}
-}
-
-//
-// You need to use this function to start a search again from the beginning.
-// You do not need to do it for the first search, though you could.
-//
-void OW_ResetSearch(OneWire_HandleTypeDef* ow)
-{
-  // reset the search state
-  ow->LastDiscrepancy = 0;
-  ow->LastDeviceFlag = false;
-  ow->LastFamilyDiscrepancy = 0;
-  for(int i = 7; ; i--)
-  {
-    ow->ROM_NO[i] = 0;
-    if ( i == 0) break;
-  }
-}
-
-// Setup the search to find the device type 'family_code' on the next call
-// to search(*newAddr) if it is present.
-//
-void OW_TargetSearch(OneWire_HandleTypeDef* ow, uint8_t family_code)
-{
-   // set the search state to find SearchFamily type devices
-   ow->ROM_NO[0] = family_code;
-   for (uint8_t i = 1; i < 8; i++)
-      ow->ROM_NO[i] = 0;
-   ow->LastDiscrepancy = 64;
-   ow->LastFamilyDiscrepancy = 0;
-   ow->LastDeviceFlag = false;
-}
-
-uint8_t OW_Search(OneWire_HandleTypeDef* ow, uint8_t *buf, uint8_t num)
-{
-
-	uint8_t found = 0;
-	uint8_t *lastDevice = NULL;
-	uint8_t *curDevice = buf;
-	uint8_t numBit, lastCollision, currentCollision, currentSelection;
-
-	lastCollision = 0;
-
-	while (found < num)
-	{
-		numBit = 1;
-		currentCollision = 0;
-
-		OW_Send(ow, (uint8_t*)"\xf0", 1, NULL, 0, OW_NO_READ);
-
-		for (numBit = 1; numBit <= 64; numBit++)
-		{
-			OW_ToBits(OW_READ_SLOT, ow->ROM_NO);
-			OW_SendBits(ow, 2);
-
-			if (ow->ROM_NO[0] == OW_R_1)
-			{
-				if (ow->ROM_NO[1] == OW_R_1)
-				{
-					return found;
-				}
-				else
-				{
-					currentSelection = 1;
-				}
-			}
-			else
-			{
-				if (ow->ROM_NO[1] == OW_R_1)
-				{
-					currentSelection = 0;
-				}
-				else
-				{
-					if (numBit < lastCollision)
-					{
-							if (lastDevice[(numBit - 1) >> 3] & 1 << ((numBit - 1) & 0x07))
-							{
-							currentSelection = 1;
-
-								if (currentCollision < numBit)
-								{
-										currentCollision = numBit;
-								}
-							}
-							else
-							{
-								currentSelection = 0;
-							}
-					}
-					else
-					{
-						if (numBit == lastCollision)
-						{
-								currentSelection = 0;
-						}
-						else
-						{
-							currentSelection = 1;
-
-							if (currentCollision < numBit)
-							{
-									currentCollision = numBit;
-							}
-						}
-					}
-				}
-			}
-
-			if (currentSelection == 1)
-			{
-				curDevice[(numBit - 1) >> 3] |= 1 << ((numBit - 1) & 0x07);
-				OW_ToBits(0x01, ow->ROM_NO);
-			}
-			else
-			{
-				curDevice[(numBit - 1) >> 3] &= ~(1 << ((numBit - 1) & 0x07));
-				OW_ToBits(0x00, ow->ROM_NO);
-			}
-
-			OW_SendBits(ow, 1);
-		}
-
-		found++;
-		lastDevice = curDevice;
-		curDevice += 8;
-		if (currentCollision == 0)
-		{
-			return found;
-		}
-
-		lastCollision = currentCollision;
-	}
-
-        return found;
-}
-
-#endif
-
-#if ONEWIRE_CRC
-// The 1-Wire CRC scheme is described in Maxim Application Note 27:
-// "Understanding and Using Cyclic Redundancy Checks with Maxim iButton Products"
-//
-
-#if ONEWIRE_CRC8_TABLE
-// Dow-CRC using polynomial X^8 + X^5 + X^4 + X^0
-// Tiny 2x16 entry CRC table created by Arjen Lentz
-// See http://lentz.com.au/blog/calculating-crc-with-a-tiny-32-entry-lookup-table
-static const uint8_t dscrc2x16_table[] = {
-	0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83,
-	0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
-	0x00, 0x9D, 0x23, 0xBE, 0x46, 0xDB, 0x65, 0xF8,
-	0x8C, 0x11, 0xAF, 0x32, 0xCA, 0x57, 0xE9, 0x74
-};
-
-// Compute a Dallas Semiconductor 8 bit CRC. These show up in the ROM
-// and the registers.  (Use tiny 2x16 entry CRC table)
-uint8_t OW_Crc8(const uint8_t *addr, uint8_t len)
-{
-	uint8_t crc = 0;
-
-	while (len--)
-	{
-		crc = *addr++ ^ crc;  // just re-using crc as intermediate
-		crc = dscrc2x16_table[crc & 0x0f] ^ dscrc2x16_table[16 + ((crc >> 4) & 0x0f)];
-	}
-
-	return crc;
-}
-#else
-//
-// Compute a Dallas Semiconductor 8 bit CRC directly.
-// this is much slower, but a little smaller, than the lookup table.
-//
-uint8_t OW_Crc8(const uint8_t *addr, uint8_t len)
-{
-	uint8_t crc = 0;
-
-	while (len--)
-	{
-		uint8_t inbyte = *addr++;
-		for (uint8_t i = 8; i; i--)
-		{
-			uint8_t mix = (crc ^ inbyte) & 0x01;
-			crc >>= 1;
-			if (mix) crc ^= 0x8C;
-			inbyte >>= 1;
-		}
-	}
-	return crc;
-}
-#endif
-
-#if ONEWIRE_CRC16
-bool OW_CheckCrc16(const uint8_t* input, uint16_t len, const uint8_t* inverted_crc, uint16_t crc)
-{
-    crc = ~OW_Crc16(input, len, crc);
-    return (crc & 0xFF) == inverted_crc[0] && (crc >> 8) == inverted_crc[1];
-}
-
-uint16_t OW_Crc16(const uint8_t* input, uint16_t len, uint16_t crc)
-{
-    static const uint8_t oddparity[16] = { 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0 };
-
-    for (uint16_t i = 0 ; i < len ; i++)
-    {
-      // Even though we're just copying a byte from the input,
-      // we'll be doing 16-bit computation with it.
-      uint16_t cdata = input[i];
-      cdata = (cdata ^ crc) & 0xff;
-      crc >>= 8;
-
-      if (oddparity[cdata & 0x0F] ^ oddparity[cdata >> 4])
-          crc ^= 0xC001;
-
-      cdata <<= 6;
-      crc ^= cdata;
-      cdata <<= 1;
-      crc ^= cdata;
-    }
-
-    return crc;
-}
-#endif
-
-#endif
+/*
+ * OneWire.c
+ *
+ *  Created on: Dec 16, 2020
+ *      Author: Andriy Honcharenko
+ */
+#include "OneWire.h"
+#include "OneWire_Slots.h"
+
+#define OW_RESET_BAUD		9600
+#define OW_DATA_BAUD		115200
+
+
+static HAL_StatusTypeDef OW_UART_Init(OneWire_HandleTypeDef* ow, uint32_t baudRate);
+static void OW_SetBaud(OneWire_HandleTypeDef* ow, uint32_t baudRate);
+static void OW_Transfer(OneWire_HandleTypeDef* ow, uint8_t *slots, uint16_t len);
+static uint8_t OW_BurstBytes(OneWire_HandleTypeDef* ow, uint8_t remaining, uint16_t headSlots);
+static void OW_SendBytes(OneWire_HandleTypeDef* ow, uint16_t headSlots, uint8_t *command, uint8_t cLen, uint8_t *data, uint8_t dLen, uint8_t readStart);
+#if ONEWIRE_CRC
+static uint8_t OW_Crc8Step(uint8_t crc, uint8_t inbyte);
+#if ONEWIRE_CRC16
+static uint16_t OW_Crc16Step(uint16_t crc, uint8_t inbyte);
+#endif
+static void OW_StreamCrcByte(OneWire_HandleTypeDef* ow, uint8_t owByte);
+#endif
+
+#if ONEWIRE_ASYNC
+static uint8_t OW_Queue(OneWire_HandleTypeDef* ow, uint8_t type, uint8_t len, const uint8_t *tx, uint8_t *rx);
+static void OW_AsyncKick(OneWire_HandleTypeDef* ow);
+static void OW_AsyncComplete(OneWire_HandleTypeDef* ow);
+static void OW_AsyncFinish(OneWire_HandleTypeDef* ow, uint8_t status);
+#endif
+
+#if ONEWIRE_SEARCH
+static void OW_SendBits(OneWire_HandleTypeDef* ow, uint8_t num_bits);
+static void OW_RestartSearch(OneWire_HandleTypeDef* ow);
+#endif
+
+static HAL_StatusTypeDef OW_UART_Init(OneWire_HandleTypeDef* ow, uint32_t baudRate)
+{
+	UART_HandleTypeDef* HUARTx = ow->huart;
+
+	/*Configure GPIO pin : ONE_WIRE_Pin */
+//	GPIO_InitTypeDef GPIO_InitStruct = {0};
+//	GPIO_InitStruct.Pin = GPIO_PIN_10;
+//	GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
+//	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+//	HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+
+    HUARTx->Init.BaudRate = baudRate;
+    HUARTx->Init.WordLength = UART_WORDLENGTH_8B;
+    HUARTx->Init.StopBits = UART_STOPBITS_1;
+    HUARTx->Init.Parity = UART_PARITY_NONE;
+    HUARTx->Init.Mode = UART_MODE_TX_RX;
+    HUARTx->Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    HUARTx->Init.OverSampling = UART_OVERSAMPLING_16;
+	return HAL_HalfDuplex_Init(HUARTx);
+}
+
+// Switch between OW_RESET_BAUD and OW_DATA_BAUD
+static void OW_SetBaud(OneWire_HandleTypeDef* ow, uint32_t baudRate)
+{
+#if ONEWIRE_FAST_BAUD
+	UART_HandleTypeDef* HUARTx = ow->huart;
+
+	// some UARTs only accept a new BRR while disabled
+	__HAL_UART_DISABLE(HUARTx);
+	HUARTx->Instance->BRR = (baudRate == OW_RESET_BAUD) ? ow->brrReset : ow->brrData;
+	HUARTx->Init.BaudRate = baudRate;
+	__HAL_UART_ENABLE(HUARTx);
+#else
+	OW_UART_Init(ow, baudRate);
+#endif
+}
+
+// Clock 'len' slots out of 'slots' and read the echo back into the same
+// buffer with one TX/RX DMA pair, then wait for the end of the transfer.
+static void OW_Transfer(OneWire_HandleTypeDef* ow, uint8_t *slots, uint16_t len)
+{
+#if ONEWIRE_STATS
+	ow->stats.dmaStarts++;
+#endif
+
+	HAL_UART_Receive_DMA(ow->huart, slots, len);
+	HAL_UART_Transmit_DMA(ow->huart, slots, len);
+
+	/*## Wait for the end of the transfer ###################################*/
+	while (HAL_UART_GetState(ow->huart) != HAL_UART_STATE_READY)
+	{
+		__NOP();
+	}
+}
+
+// Number of the 'remaining' bytes that go into the next burst, behind
+// 'headSlots' slots already in the slot buffer
+static uint8_t OW_BurstBytes(OneWire_HandleTypeDef* ow, uint8_t remaining, uint16_t headSlots)
+{
+#if ONEWIRE_SINGLE_DMA
+	uint16_t capacity = (ow->slotBufSize - headSlots) / 8;
+#else
+	uint16_t capacity = 1;
+
+	(void) ow;
+	(void) headSlots;
+#endif
+
+	return (remaining > capacity) ? (uint8_t) capacity : remaining;
+}
+
+// Clock out 'cLen' command bytes behind 'headSlots' slots the caller put
+// at the start of the slot buffer, and decode the read window of the
+// command bytes as OW_Send describes
+static void OW_SendBytes(OneWire_HandleTypeDef* ow, uint16_t headSlots, uint8_t *command, uint8_t cLen, uint8_t *data, uint8_t dLen, uint8_t readStart)
+{
+	while (cLen > 0)
+	{
+		// bit-expand as much of the command as fits into one burst
+		uint8_t *slots = &ow->slotBuf[headSlots];
+		uint8_t burstLen = OW_BurstBytes(ow, cLen, headSlots);
+		uint8_t i;
+
+		for (i = 0; i < burstLen; i++)
+		{
+			OW_ToBits(*command, &slots[i * 8]);
+			command++;
+		}
+		cLen -= burstLen;
+
+		OW_Transfer(ow, ow->slotBuf, headSlots + burstLen * 8);
+#if ONEWIRE_STATS
+		ow->stats.slots += headSlots + burstLen * 8;
+#endif
+		headSlots = 0;
+
+		// decode the read window out of the echoed slots
+		for (i = 0; i < burstLen; i++)
+		{
+			if (readStart == 0 && dLen > 0)
+			{
+				*data = OW_ToByte(&slots[i * 8]);
+#if ONEWIRE_CRC
+				OW_StreamCrcByte(ow, *data);
+#endif
+				data++;
+				dLen--;
+			}
+			else
+			{
+				if (readStart != OW_NO_READ)
+				{
+					readStart--;
+				}
+			}
+		}
+	}
+}
+
+HAL_StatusTypeDef OneWire(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart)
+{
+	return OW_Begin(ow, huart);
+}
+
+HAL_StatusTypeDef OW_Begin(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart)
+{
+	ow->huart = huart;
+	OW_SetSlotBuffer(ow, NULL, 0);
+#if ONEWIRE_FAST_BAUD
+	// let the HAL work out both divisors once, resets only swap them
+	OW_UART_Init(ow, OW_DATA_BAUD);
+	ow->brrData = huart->Instance->BRR;
+#endif
+	HAL_StatusTypeDef status = OW_UART_Init(ow, OW_RESET_BAUD);
+#if ONEWIRE_FAST_BAUD
+	ow->brrReset = huart->Instance->BRR;
+#endif
+#if ONEWIRE_SEARCH
+	OW_ResetSearch(ow);
+#endif
+#if ONEWIRE_ASYNC
+	ow->asyncCount = 0;
+	ow->asyncStatus = OW_OK;
+#endif
+#if ONEWIRE_CRC
+	ow->crcMode = OW_CRC_NONE;
+#endif
+#if ONEWIRE_STATS
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+	OW_ResetStats(ow);
+#endif
+	return status;
+}
+
+void OW_SetSlotBuffer(OneWire_HandleTypeDef* ow, uint8_t *buf, uint16_t size)
+{
+	if (buf == NULL || size < 8)
+	{
+		buf = ow->slotStorage;
+		size = sizeof(ow->slotStorage);
+	}
+
+	ow->slotBuf = buf;
+	ow->slotBufSize = size;
+}
+
+#if ONEWIRE_STATS
+void OW_ResetStats(OneWire_HandleTypeDef* ow)
+{
+	memset(&ow->stats, 0, sizeof(ow->stats));
+}
+
+uint32_t OW_GetIdleMicros(OneWire_HandleTypeDef* ow)
+{
+	uint32_t busyUs = (uint32_t) (ow->stats.busyTicks / (OW_STATS_CLOCK / 1000000));
+	// every slot is one 10 bit UART frame at the data baud rate
+	uint32_t slotUs = (uint32_t) (((uint64_t) ow->stats.slots * 10 * 1000000) / OW_DATA_BAUD);
+
+	return (busyUs > slotUs) ? busyUs - slotUs : 0;
+}
+
+uint32_t OW_GetResetMicros(OneWire_HandleTypeDef* ow)
+{
+	if (ow->stats.resets == 0)
+	{
+		return 0;
+	}
+
+	return (uint32_t) (ow->stats.resetTicks / ow->stats.resets / (OW_STATS_CLOCK / 1000000));
+}
+#endif
+
+// Perform the onewire reset function.  We will wait up to 250uS for
+// the bus to come high, if it doesn't then it is broken or shorted
+// and we return a 0;
+//
+// Returns 1 if a device asserted a presence pulse, 0 otherwise.
+//
+uint8_t OW_Reset(OneWire_HandleTypeDef* ow)
+{
+	uint8_t owPresence = 0xf0;
+
+#if ONEWIRE_STATS
+	uint32_t start = OW_STATS_TIMESTAMP();
+#endif
+
+	OW_SetBaud(ow, OW_RESET_BAUD);
+
+	//HAL_UART_Transmit(ow->huart, &owPresence, 1, HAL_MAX_DELAY);
+	OW_Transfer(ow, &owPresence, 1);
+
+	OW_SetBaud(ow, OW_DATA_BAUD);
+
+#if ONEWIRE_STATS
+	ow->stats.resets++;
+	ow->stats.resetTicks += OW_STATS_TIMESTAMP() - start;
+#endif
+
+	if (owPresence != 0xf0)
+	{
+		return OW_OK;
+	}
+
+	return OW_NO_DEVICE;
+}
+
+//-----------------------------------------------------------------------------
+// procedure bus communication 1-wire
+// sendReset - OW_SEND_RESET to start with a reset pulse, OW_NO_RESET to carry on
+// a transaction that is already in progress
+// command - an array of bytes sent to the bus. If you need reading, we send OW_READ_SLOT
+// cLen - the length of the command buffer, as many bytes will be sent to the bus
+// data - if reading is required, then a reference to the buffer for reading
+// dLen - the length of the read buffer. Read no more than this length
+// readStart - which transmission character to start reading from (numbered from 0)
+// you can specify OW_NO_READ, then you don't need to specify data and dLen
+//-----------------------------------------------------------------------------
+uint8_t OW_Send(OneWire_HandleTypeDef* ow, uint8_t sendReset, uint8_t *command, uint8_t cLen, uint8_t *data, uint8_t dLen, uint8_t readStart)
+{
+	if (sendReset == OW_SEND_RESET && OW_Reset(ow) == OW_NO_DEVICE)
+	{
+		return OW_NO_DEVICE;
+	}
+
+#if ONEWIRE_STATS
+	uint32_t start = OW_STATS_TIMESTAMP();
+	ow->stats.transactions++;
+#endif
+
+	OW_SendBytes(ow, 0, command, cLen, data, dLen, readStart);
+
+#if ONEWIRE_STATS
+	ow->stats.busyTicks += OW_STATS_TIMESTAMP() - start;
+#endif
+
+	return OW_OK;
+}
+
+uint8_t OW_SendFrame(OneWire_HandleTypeDef* ow, uint8_t sendReset, const uint8_t *frame, uint8_t frameSlots, uint8_t *command, uint8_t cLen, uint8_t *data, uint8_t dLen, uint8_t readStart)
+{
+	uint16_t headSlots = frameSlots;
+
+	if (sendReset == OW_SEND_RESET && OW_Reset(ow) == OW_NO_DEVICE)
+	{
+		return OW_NO_DEVICE;
+	}
+
+#if ONEWIRE_STATS
+	uint32_t start = OW_STATS_TIMESTAMP();
+	ow->stats.transactions++;
+#endif
+
+	// the echo overwrites the slots, so the frame is copied, not sent in place
+	if (cLen == 0 || frameSlots + 8 > ow->slotBufSize)
+	{
+		// frame alone, in as many bursts as it takes
+		while (headSlots > 0)
+		{
+			uint16_t burst = (headSlots > ow->slotBufSize) ? ow->slotBufSize : headSlots;
+
+			memcpy(ow->slotBuf, frame, burst);
+			OW_Transfer(ow, ow->slotBuf, burst);
+#if ONEWIRE_STATS
+			ow->stats.slots += burst;
+#endif
+			frame += burst;
+			headSlots -= burst;
+		}
+	}
+	else
+	{
+		// command bytes go into the same burst behind the frame
+		memcpy(ow->slotBuf, frame, headSlots);
+	}
+
+	OW_SendBytes(ow, headSlots, command, cLen, data, dLen, readStart);
+
+#if ONEWIRE_STATS
+	ow->stats.busyTicks += OW_STATS_TIMESTAMP() - start;
+#endif
+
+	return OW_OK;
+}
+
+void OW_ToSlots(const uint8_t *bytes, uint8_t len, uint8_t *slots)
+{
+	while (len > 0)
+	{
+		OW_ToBits(*bytes, slots);
+		bytes++;
+		slots += 8;
+		len--;
+	}
+}
+
+uint8_t OW_ReadBit(OneWire_HandleTypeDef* ow)
+{
+#if ONEWIRE_STATS
+	uint32_t start = OW_STATS_TIMESTAMP();
+#endif
+
+	ow->slotBuf[0] = OW_R_1;
+	OW_Transfer(ow, ow->slotBuf, 1);
+
+#if ONEWIRE_STATS
+	ow->stats.slots++;
+	ow->stats.busyTicks += OW_STATS_TIMESTAMP() - start;
+#endif
+
+	return (ow->slotBuf[0] == OW_R_1) ? 1 : 0;
+}
+
+#if ONEWIRE_ASYNC
+static uint8_t OW_Queue(OneWire_HandleTypeDef* ow, uint8_t type, uint8_t len, const uint8_t *tx, uint8_t *rx)
+{
+	if (ow->asyncStatus == OW_BUSY)
+	{
+		return OW_BUSY;
+	}
+
+	if (ow->asyncCount >= ONEWIRE_ASYNC_QUEUE)
+	{
+		return OW_ERROR;
+	}
+
+	OneWire_OpTypeDef *op = &ow->asyncQueue[ow->asyncCount++];
+	op->type = type;
+	op->len = len;
+	op->tx = tx;
+	op->rx = rx;
+
+	return OW_OK;
+}
+
+uint8_t OW_QueueReset(OneWire_HandleTypeDef* ow)
+{
+	return OW_Queue(ow, OW_OP_RESET, 0, NULL, NULL);
+}
+
+uint8_t OW_QueueWrite(OneWire_HandleTypeDef* ow, const uint8_t *data, uint8_t len)
+{
+	// the UART would refuse an empty transfer and never complete the run
+	if (len == 0)
+	{
+		return OW_ERROR;
+	}
+
+	return OW_Queue(ow, OW_OP_WRITE, len, data, NULL);
+}
+
+uint8_t OW_QueueRead(OneWire_HandleTypeDef* ow, uint8_t *data, uint8_t len)
+{
+	if (len == 0)
+	{
+		return OW_ERROR;
+	}
+
+	return OW_Queue(ow, OW_OP_READ, len, NULL, data);
+}
+
+uint8_t OW_QueueTriplet(OneWire_HandleTypeDef* ow, uint8_t direction, uint8_t *result)
+{
+	return OW_Queue(ow, OW_OP_TRIPLET, direction ? 1 : 0, NULL, result);
+}
+
+uint8_t OW_AsyncStart(OneWire_HandleTypeDef* ow, OW_AsyncCallback *callback, void* context)
+{
+	if (ow->asyncStatus == OW_BUSY)
+	{
+		return OW_BUSY;
+	}
+
+	if (ow->asyncCount == 0)
+	{
+		return OW_ERROR;
+	}
+
+	ow->asyncCallback = callback;
+	ow->asyncContext = context;
+	ow->asyncIndex = 0;
+	ow->asyncPhase = 0;
+	ow->asyncStatus = OW_BUSY;
+
+	OW_AsyncKick(ow);
+
+	return OW_OK;
+}
+
+uint8_t OW_AsyncStatus(OneWire_HandleTypeDef* ow)
+{
+	return ow->asyncStatus;
+}
+
+// Arm the DMA for the current phase of the current operation.
+// asyncPhase is the byte offset of a write/read, or the step of a triplet.
+static void OW_AsyncKick(OneWire_HandleTypeDef* ow)
+{
+	OneWire_OpTypeDef *op = &ow->asyncQueue[ow->asyncIndex];
+	uint8_t *slots = ow->slotBuf;
+	uint16_t len = 0;
+	uint8_t i, n;
+
+	switch (op->type)
+	{
+	case OW_OP_RESET:
+		OW_SetBaud(ow, OW_RESET_BAUD);
+		slots[0] = 0xf0;
+		len = 1;
+		break;
+
+	case OW_OP_WRITE:
+	case OW_OP_READ:
+		n = OW_BurstBytes(ow, op->len - ow->asyncPhase, 0);
+		for (i = 0; i < n; i++)
+		{
+			OW_ToBits((op->type == OW_OP_WRITE) ? op->tx[ow->asyncPhase + i] : OW_READ_SLOT, &slots[i * 8]);
+		}
+		len = n * 8;
+		break;
+
+	case OW_OP_TRIPLET:
+		if (ow->asyncPhase == 0)
+		{
+			slots[0] = OW_R_1;
+			slots[1] = OW_R_1;
+			len = 2;
+		}
+		else
+		{
+			slots[0] = (*op->rx & OW_TRIPLET_DIR) ? OW_1 : OW_0;
+			len = 1;
+		}
+		break;
+	}
+
+#if ONEWIRE_STATS
+	ow->stats.dmaStarts++;
+	if (op->type != OW_OP_RESET)
+	{
+		ow->stats.slots += len;
+	}
+#endif
+
+	ow->asyncTxDone = false;
+	ow->asyncRxDone = false;
+	HAL_UART_Receive_DMA(ow->huart, slots, len);
+	HAL_UART_Transmit_DMA(ow->huart, slots, len);
+}
+
+// Both halves of the current transfer are done: consume the echo and
+// start the next phase, the next operation or end the run.
+static void OW_AsyncComplete(OneWire_HandleTypeDef* ow)
+{
+	OneWire_OpTypeDef *op = &ow->asyncQueue[ow->asyncIndex];
+	uint8_t *slots = ow->slotBuf;
+	uint8_t i, n;
+
+	switch (op->type)
+	{
+	case OW_OP_RESET:
+		OW_SetBaud(ow, OW_DATA_BAUD);
+#if ONEWIRE_STATS
+		ow->stats.resets++;
+#endif
+		if (slots[0] == 0xf0)
+		{
+			OW_AsyncFinish(ow, OW_NO_DEVICE);
+			return;
+		}
+		break;
+
+	case OW_OP_WRITE:
+	case OW_OP_READ:
+		n = OW_BurstBytes(ow, op->len - ow->asyncPhase, 0);
+		if (op->type == OW_OP_READ)
+		{
+			for (i = 0; i < n; i++)
+			{
+				op->rx[ow->asyncPhase + i] = OW_ToByte(&slots[i * 8]);
+#if ONEWIRE_CRC
+				OW_StreamCrcByte(ow, op->rx[ow->asyncPhase + i]);
+#endif
+			}
+		}
+		ow->asyncPhase += n;
+		if (ow->asyncPhase < op->len)
+		{
+			OW_AsyncKick(ow);
+			return;
+		}
+		break;
+
+	case OW_OP_TRIPLET:
+		if (ow->asyncPhase == 0)
+		{
+			uint8_t id = (slots[0] == OW_R_1) ? OW_TRIPLET_ID : 0;
+			uint8_t cmp = (slots[1] == OW_R_1) ? OW_TRIPLET_CMP : 0;
+
+			*op->rx = id | cmp;
+			if (id && cmp)
+			{
+				break;
+			}
+			if (id || (!cmp && op->len))
+			{
+				*op->rx |= OW_TRIPLET_DIR;
+			}
+			ow->asyncPhase = 1;
+			OW_AsyncKick(ow);
+			return;
+		}
+		break;
+	}
+
+	ow->asyncPhase = 0;
+	if (++ow->asyncIndex >= ow->asyncCount)
+	{
+		OW_AsyncFinish(ow, OW_OK);
+	}
+	else
+	{
+		OW_AsyncKick(ow);
+	}
+}
+
+static void OW_AsyncFinish(OneWire_HandleTypeDef* ow, uint8_t status)
+{
+	ow->asyncCount = 0;
+	ow->asyncStatus = status;
+
+	if (ow->asyncCallback != NULL)
+	{
+		ow->asyncCallback(ow->asyncContext, status);
+	}
+}
+
+// TX and RX complete arrive from different interrupts in either order.
+// Whichever comes second moves the engine on.
+void OW_TxCpltCallback(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart)
+{
+	if (huart != ow->huart || ow->asyncStatus != OW_BUSY)
+	{
+		return;
+	}
+
+	ow->asyncTxDone = true;
+	if (ow->asyncRxDone)
+	{
+		OW_AsyncComplete(ow);
+	}
+}
+
+void OW_RxCpltCallback(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart)
+{
+	if (huart != ow->huart || ow->asyncStatus != OW_BUSY)
+	{
+		return;
+	}
+
+	ow->asyncRxDone = true;
+	if (ow->asyncTxDone)
+	{
+		OW_AsyncComplete(ow);
+	}
+}
+
+void OW_ErrorCallback(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart)
+{
+	if (huart != ow->huart || ow->asyncStatus != OW_BUSY)
+	{
+		return;
+	}
+
+	HAL_UART_Abort(ow->huart);
+	OW_UART_Init(ow, OW_DATA_BAUD);
+	OW_AsyncFinish(ow, OW_ERROR);
+}
+#endif
+
+#if ONEWIRE_SEARCH
+static void OW_SendBits(OneWire_HandleTypeDef* ow, uint8_t numBits)
+{
+#if ONEWIRE_STATS
+	uint32_t start = OW_STATS_TIMESTAMP();
+#endif
+
+	OW_Transfer(ow, ow->slotBuf, numBits);
+
+#if ONEWIRE_STATS
+	ow->stats.slots += numBits;
+	ow->stats.busyTicks += OW_STATS_TIMESTAMP() - start;
+#endif
+}
+
+//
+// You need to use this function to start a search again from the beginning.
+// You do not need to do it for the first search, though you could.
+//
+void OW_ResetSearch(OneWire_HandleTypeDef* ow)
+{
+  // reset the search state
+  ow->LastDiscrepancy = 0;
+  ow->LastDeviceFlag = false;
+  ow->LastFamilyDiscrepancy = 0;
+  ow->searchBit = 0;
+  ow->searchFamily = 0;
+  ow->searchCommand = 0xF0;		// Search ROM
+  for(int i = 7; ; i--)
+  {
+    ow->ROM_NO[i] = 0;
+    if ( i == 0) break;
+  }
+}
+
+// Start the search over after a bus error, still for the same family
+// and kind of devices
+static void OW_RestartSearch(OneWire_HandleTypeDef* ow)
+{
+	uint8_t searchFamily = ow->searchFamily;
+	uint8_t searchCommand = ow->searchCommand;
+
+	if (searchFamily != 0)
+		OW_TargetSearch(ow, searchFamily);
+	else
+		OW_ResetSearch(ow);
+
+	ow->searchCommand = searchCommand;
+}
+
+//
+// Same as OW_ResetSearch, but the following searches only find devices
+// with an alarm condition (Conditional Search).
+//
+void OW_ResetAlarmSearch(OneWire_HandleTypeDef* ow)
+{
+  OW_ResetSearch(ow);
+  ow->searchCommand = 0xEC;		// Conditional Search
+}
+
+// Setup the search to find only devices of type 'family_code' with the
+// following OW_SearchNext/OW_SearchStep calls, until OW_ResetSearch.
+// Only the branch of the ROM tree below the family code is walked.
+//
+void OW_TargetSearch(OneWire_HandleTypeDef* ow, uint8_t family_code)
+{
+   // set the search state to find SearchFamily type devices
+   ow->ROM_NO[0] = family_code;
+   for (uint8_t i = 1; i < 8; i++)
+      ow->ROM_NO[i] = 0;
+   ow->LastDiscrepancy = 0;
+   ow->LastFamilyDiscrepancy = 0;
+   ow->LastDeviceFlag = false;
+   ow->searchBit = 0;
+   ow->searchFamily = family_code;
+}
+
+// Works on the search of the handle for at most 'maxTriplets' of the 64
+// ROM bits (2 read slots and 1 write slot each), the first call of a
+// device also sends the reset and the Search ROM command.  The search
+// state is kept in the handle between calls, so the search can be spread
+// over several passes of the main loop; the bus must not be used for
+// anything else until the device is done.
+// Returns OW_BUSY if the device is not complete yet, OW_OK once its ROM
+// code is copied to newAddr, OW_NO_DEVICE if there are no more devices.
+// LastDeviceFlag tells a search that went through from one cut short by
+// a bus error (which also resets the search).  No presence pulse before
+// the first device is an empty bus, a search that went through.
+uint8_t OW_SearchStep(OneWire_HandleTypeDef* ow, uint8_t *newAddr, uint8_t maxTriplets)
+{
+	if (ow->searchBit == 0)
+	{
+		if (ow->LastDeviceFlag)
+		{
+			return OW_NO_DEVICE;
+		}
+
+		uint8_t result = OW_Send(ow, OW_SEND_RESET, &ow->searchCommand, 1, NULL, 0, OW_NO_READ);
+		if (result != OW_OK)
+		{
+			bool empty = (result == OW_NO_DEVICE && ow->LastDiscrepancy == 0);
+
+			OW_RestartSearch(ow);
+			ow->LastDeviceFlag = empty;
+			return OW_NO_DEVICE;
+		}
+
+		ow->searchBit = 1;
+		ow->searchLastOne = 0;
+	}
+
+	for (; maxTriplets > 0 && ow->searchBit <= 64; maxTriplets--, ow->searchBit++)
+	{
+		uint8_t idBit = ow->searchBit;
+		uint8_t romByte = (idBit - 1) >> 3;
+		uint8_t romMask = 1 << ((idBit - 1) & 0x07);
+		uint8_t direction;
+
+		ow->slotBuf[0] = OW_R_1;
+		ow->slotBuf[1] = OW_R_1;
+		OW_SendBits(ow, 2);
+
+		bool idBitSet = (ow->slotBuf[0] == OW_R_1);
+		bool cmpBitSet = (ow->slotBuf[1] == OW_R_1);
+
+		// nobody answered
+		if (idBitSet && cmpBitSet)
+		{
+			OW_RestartSearch(ow);
+			return OW_NO_DEVICE;
+		}
+
+		if (ow->searchFamily != 0 && idBit < 9)
+		{
+			// stay on the branch of the target family
+			direction = ((ow->searchFamily & romMask) != 0);
+
+			// all remaining devices disagree: the family is done
+			if (idBitSet != cmpBitSet && idBitSet != direction)
+			{
+				ow->searchBit = 0;
+				ow->LastDeviceFlag = true;
+				return OW_NO_DEVICE;
+			}
+		}
+		else if (idBitSet != cmpBitSet)
+		{
+			// all remaining devices agree on this bit
+			direction = idBitSet;
+		}
+		else
+		{
+			// discrepancy: repeat the path of the last device before the
+			// last discrepancy, take 0 at it and 1 after it
+			if (idBit < ow->LastDiscrepancy)
+				direction = ((ow->ROM_NO[romByte] & romMask) != 0);
+			else
+				direction = (idBit != ow->LastDiscrepancy);
+
+			if (direction == 1)
+			{
+				ow->searchLastOne = idBit;
+				if (idBit < 9)
+					ow->LastFamilyDiscrepancy = idBit;
+			}
+		}
+
+		if (direction)
+		{
+			ow->ROM_NO[romByte] |= romMask;
+			ow->slotBuf[0] = OW_1;
+		}
+		else
+		{
+			ow->ROM_NO[romByte] &= ~romMask;
+			ow->slotBuf[0] = OW_0;
+		}
+
+		OW_SendBits(ow, 1);
+	}
+
+	if (ow->searchBit <= 64)
+	{
+		return OW_BUSY;
+	}
+
+	ow->searchBit = 0;
+	ow->LastDiscrepancy = ow->searchLastOne;
+	ow->LastDeviceFlag = (ow->searchLastOne == 0);
+
+	if (ow->ROM_NO[0] == 0)
+	{
+		OW_RestartSearch(ow);
+		return OW_NO_DEVICE;
+	}
+
+	memcpy(newAddr, ow->ROM_NO, 8);
+	return OW_OK;
+}
+
+// Finds the next device of the search started by OW_ResetSearch or
+// OW_TargetSearch and copies its ROM code to newAddr.  Only the search
+// state of the handle is kept between calls, so buses of any size can be
+// enumerated one device at a time with constant stack use.
+// Devices come in the same order as from OW_Search.
+// Returns false if there are no more devices.
+bool OW_SearchNext(OneWire_HandleTypeDef* ow, uint8_t *newAddr)
+{
+	// 64 triplets always finish the device
+	return OW_SearchStep(ow, newAddr, 64) == OW_OK;
+}
+
+// Checks with a search along its ROM code that the device 'addr' is on the
+// bus.  Works for any family, also devices without a scratchpad.  The
+// search state of the handle is left as it was.
+bool OW_Verify(OneWire_HandleTypeDef* ow, const uint8_t *addr)
+{
+	uint8_t romBackup[8];
+	uint8_t found[8];
+	uint8_t lastDiscrepancy = ow->LastDiscrepancy;
+	uint8_t lastFamilyDiscrepancy = ow->LastFamilyDiscrepancy;
+	bool lastDeviceFlag = ow->LastDeviceFlag;
+	uint8_t searchFamily = ow->searchFamily;
+	uint8_t searchCommand = ow->searchCommand;
+	bool result;
+
+	memcpy(romBackup, ow->ROM_NO, 8);
+
+	// follow the ROM code at every discrepancy
+	memcpy(ow->ROM_NO, addr, 8);
+	ow->LastDiscrepancy = 64;
+	ow->LastDeviceFlag = false;
+	ow->searchBit = 0;
+	ow->searchFamily = 0;
+	ow->searchCommand = 0xF0;
+
+	result = OW_SearchNext(ow, found) && memcmp(found, addr, 8) == 0;
+
+	memcpy(ow->ROM_NO, romBackup, 8);
+	ow->LastDiscrepancy = lastDiscrepancy;
+	ow->LastFamilyDiscrepancy = lastFamilyDiscrepancy;
+	ow->LastDeviceFlag = lastDeviceFlag;
+	ow->searchFamily = searchFamily;
+	ow->searchCommand = searchCommand;
+	// a device half done by OW_SearchStep starts over with a new reset
+	ow->searchBit = 0;
+
+	return result;
+}
+
+uint8_t OW_Search(OneWire_HandleTypeDef* ow, uint8_t *buf, uint8_t num)
+{
+
+	uint8_t found = 0;
+	uint8_t *lastDevice = NULL;
+	uint8_t *curDevice = buf;
+	uint8_t numBit, lastCollision, currentCollision, currentSelection;
+
+	lastCollision = 0;
+
+	while (found < num)
+	{
+		numBit = 1;
+		currentCollision = 0;
+
+		OW_Send(ow, OW_SEND_RESET, (uint8_t*)"\xf0", 1, NULL, 0, OW_NO_READ);
+
+		for (numBit = 1; numBit <= 64; numBit++)
+		{
+			ow->slotBuf[0] = OW_R_1;
+			ow->slotBuf[1] = OW_R_1;
+			OW_SendBits(ow, 2);
+
+			if (ow->slotBuf[0] == OW_R_1)
+			{
+				if (ow->slotBuf[1] == OW_R_1)
+				{
+					return found;
+				}
+				else
+				{
+					currentSelection = 1;
+				}
+			}
+			else
+			{
+				if (ow->slotBuf[1] == OW_R_1)
+				{
+					currentSelection = 0;
+				}
+				else
+				{
+					if (numBit < lastCollision)
+					{
+							if (lastDevice[(numBit - 1) >> 3] & 1 << ((numBit - 1) & 0x07))
+							{
+							currentSelection = 1;
+
+								if (currentCollision < numBit)
+								{
+										currentCollision = numBit;
+								}
+							}
+							else
+							{
+								currentSelection = 0;
+							}
+					}
+					else
+					{
+						if (numBit == lastCollision)
+						{
+								currentSelection = 0;
+						}
+						else
+						{
+							currentSelection = 1;
+
+							if (currentCollision < numBit)
+							{
+									currentCollision = numBit;
+							}
+						}
+					}
+				}
+			}
+
+			if (currentSelection == 1)
+			{
+				curDevice[(numBit - 1) >> 3] |= 1 << ((numBit - 1) & 0x07);
+				ow->slotBuf[0] = OW_1;
+			}
+			else
+			{
+				curDevice[(numBit - 1) >> 3] &= ~(1 << ((numBit - 1) & 0x07));
+				ow->slotBuf[0] = OW_0;
+			}
+
+			OW_SendBits(ow, 1);
+		}
+
+		found++;
+		memcpy(ow->ROM_NO, curDevice, 8);
+		lastDevice = curDevice;
+		curDevice += 8;
+		if (currentCollision == 0)
+		{
+			return found;
+		}
+
+		lastCollision = currentCollision;
+	}
+
+        return found;
+}
+
+#endif
+
+#if ONEWIRE_CRC
+// The 1-Wire CRC scheme is described in Maxim Application Note 27:
+// "Understanding and Using Cyclic Redundancy Checks with Maxim iButton Products"
+//
+
+#if ONEWIRE_CRC_HOOK
+static OW_Crc8Hook *crc8Hook = NULL;
+#if ONEWIRE_CRC16
+static OW_Crc16Hook *crc16Hook = NULL;
+#endif
+
+void OW_SetCrcHooks(OW_Crc8Hook *crc8, OW_Crc16Hook *crc16)
+{
+	crc8Hook = crc8;
+#if ONEWIRE_CRC16
+	crc16Hook = crc16;
+#else
+	(void) crc16;
+#endif
+}
+#endif
+
+#if ONEWIRE_CRC8_TABLE == 2
+// Dow-CRC using polynomial X^8 + X^5 + X^4 + X^0
+// Full 256 entry table, one lookup per byte
+static const uint8_t dscrc_table[] = {
+	0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83,
+	0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+	0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E,
+	0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC,
+	0x23, 0x7D, 0x9F, 0xC1, 0x42, 0x1C, 0xFE, 0xA0,
+	0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
+	0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D,
+	0x7C, 0x22, 0xC0, 0x9E, 0x1D, 0x43, 0xA1, 0xFF,
+	0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5,
+	0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07,
+	0xDB, 0x85, 0x67, 0x39, 0xBA, 0xE4, 0x06, 0x58,
+	0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
+	0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6,
+	0xA7, 0xF9, 0x1B, 0x45, 0xC6, 0x98, 0x7A, 0x24,
+	0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B,
+	0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9,
+	0x8C, 0xD2, 0x30, 0x6E, 0xED, 0xB3, 0x51, 0x0F,
+	0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
+	0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92,
+	0xD3, 0x8D, 0x6F, 0x31, 0xB2, 0xEC, 0x0E, 0x50,
+	0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C,
+	0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE,
+	0x32, 0x6C, 0x8E, 0xD0, 0x53, 0x0D, 0xEF, 0xB1,
+	0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
+	0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49,
+	0x08, 0x56, 0xB4, 0xEA, 0x69, 0x37, 0xD5, 0x8B,
+	0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4,
+	0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16,
+	0xE9, 0xB7, 0x55, 0x0B, 0x88, 0xD6, 0x34, 0x6A,
+	0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
+	0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7,
+	0xB6, 0xE8, 0x0A, 0x54, 0xD7, 0x89, 0x6B, 0x35
+};
+
+// One byte of a Dallas Semiconductor 8 bit CRC.  (Use 256 entry CRC table)
+static uint8_t OW_Crc8Step(uint8_t crc, uint8_t inbyte)
+{
+	return dscrc_table[inbyte ^ crc];
+}
+#elif ONEWIRE_CRC8_TABLE
+// Dow-CRC using polynomial X^8 + X^5 + X^4 + X^0
+// Tiny 2x16 entry CRC table created by Arjen Lentz
+// See http://lentz.com.au/blog/calculating-crc-with-a-tiny-32-entry-lookup-table
+static const uint8_t dscrc2x16_table[] = {
+	0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83,
+	0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+	0x00, 0x9D, 0x23, 0xBE, 0x46, 0xDB, 0x65, 0xF8,
+	0x8C, 0x11, 0xAF, 0x32, 0xCA, 0x57, 0xE9, 0x74
+};
+
+// One byte of a Dallas Semiconductor 8 bit CRC.  (Use tiny 2x16 entry CRC table)
+static uint8_t OW_Crc8Step(uint8_t crc, uint8_t inbyte)
+{
+	crc = inbyte ^ crc;  // just re-using crc as intermediate
+	return dscrc2x16_table[crc & 0x0f] ^ dscrc2x16_table[16 + ((crc >> 4) & 0x0f)];
+}
+#else
+//
+// One byte of a Dallas Semiconductor 8 bit CRC, computed directly.
+// this is much slower, but a little smaller, than the lookup table.
+//
+static uint8_t OW_Crc8Step(uint8_t crc, uint8_t inbyte)
+{
+	for (uint8_t i = 8; i; i--)
+	{
+		uint8_t mix = (crc ^ inbyte) & 0x01;
+		crc >>= 1;
+		if (mix) crc ^= 0x8C;
+		inbyte >>= 1;
+	}
+	return crc;
+}
+#endif
+
+// Compute a Dallas Semiconductor 8 bit CRC. These show up in the ROM
+// and the registers.
+uint8_t OW_Crc8(const uint8_t *addr, uint8_t len)
+{
+	uint8_t crc = 0;
+
+#if ONEWIRE_CRC_HOOK
+	if (crc8Hook != NULL)
+		return crc8Hook(addr, len);
+#endif
+
+	while (len--)
+	{
+		crc = OW_Crc8Step(crc, *addr++);
+	}
+
+	return crc;
+}
+
+void OW_StreamCrc(OneWire_HandleTypeDef* ow, uint8_t mode, uint16_t seed)
+{
+	ow->crcMode = mode;
+	ow->crc = seed;
+}
+
+uint16_t OW_GetStreamCrc(OneWire_HandleTypeDef* ow)
+{
+	return ow->crc;
+}
+
+bool OW_StreamCrcOk(OneWire_HandleTypeDef* ow)
+{
+#if ONEWIRE_CRC16
+	// the inverted CRC16 sent by the device leaves this residue
+	if (ow->crcMode == OW_CRC_16)
+		return ow->crc == 0xB001;
+#endif
+
+	return ow->crcMode == OW_CRC_8 && ow->crc == 0;
+}
+
+// Feed a byte just decoded from the bus into the running CRC
+static void OW_StreamCrcByte(OneWire_HandleTypeDef* ow, uint8_t owByte)
+{
+	if (ow->crcMode == OW_CRC_8)
+	{
+		ow->crc = OW_Crc8Step((uint8_t) ow->crc, owByte);
+	}
+#if ONEWIRE_CRC16
+	else if (ow->crcMode == OW_CRC_16)
+	{
+		ow->crc = OW_Crc16Step(ow->crc, owByte);
+	}
+#endif
+}
+
+#if ONEWIRE_CRC16
+bool OW_CheckCrc16(const uint8_t* input, uint16_t len, const uint8_t* inverted_crc, uint16_t crc)
+{
+    crc = ~OW_Crc16(input, len, crc);
+    return (crc & 0xFF) == inverted_crc[0] && (crc >> 8) == inverted_crc[1];
+}
+
+#if ONEWIRE_CRC16_TABLE
+// CRC16 using polynomial X^16 + X^15 + X^2 + X^0, bit reflected
+static const uint16_t crc16_table[] = {
+	0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+	0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+	0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+	0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+	0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+	0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+	0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+	0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+	0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+	0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+	0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+	0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+	0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+	0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+	0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+	0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+	0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+	0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+	0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+	0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+	0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+	0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+	0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+	0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+	0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+	0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+	0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+	0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+	0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+	0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+	0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+	0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+
+static uint16_t OW_Crc16Step(uint16_t crc, uint8_t inbyte)
+{
+    return (crc >> 8) ^ crc16_table[(crc ^ inbyte) & 0xff];
+}
+#else
+static uint16_t OW_Crc16Step(uint16_t crc, uint8_t inbyte)
+{
+    static const uint8_t oddparity[16] = { 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0 };
+
+    // Even though we're just copying a byte from the input,
+    // we'll be doing 16-bit computation with it.
+    uint16_t cdata = inbyte;
+    cdata = (cdata ^ crc) & 0xff;
+    crc >>= 8;
+
+    if (oddparity[cdata & 0x0F] ^ oddparity[cdata >> 4])
+        crc ^= 0xC001;
+
+    cdata <<= 6;
+    crc ^= cdata;
+    cdata <<= 1;
+    crc ^= cdata;
+
+    return crc;
+}
+#endif
+
+uint16_t OW_Crc16(const uint8_t* input, uint16_t len, uint16_t crc)
+{
+#if ONEWIRE_CRC_HOOK
+    if (crc16Hook != NULL)
+        return crc16Hook(input, len, crc);
+#endif
+
+    for (uint16_t i = 0 ; i < len ; i++)
+    {
+      crc = OW_Crc16Step(crc, input[i]);
+    }
+
+    return crc;
+}
+#endif
+
+#if ONEWIRE_CRC_HOOK && defined(CRC_CR_POLYSIZE)
+// CRC unit with programmable polynomial (STM32F0/F3/F7/G0/G4/H7/L0/L4...).
+// The 1-Wire CRCs are bit reflected: input bytes and the result are
+// reversed by the unit, the seed has to be reversed by hand.
+
+// Feed one byte to the unit.  A host stand-in of the unit defines this to
+// see the byte writes, which a plain struct in memory would not.
+#ifndef OW_CRC_DR_WRITE8
+#define OW_CRC_DR_WRITE8(b)	(*(__IO uint8_t *) &CRC->DR = (b))
+#endif
+
+uint8_t OW_HwCrc8(const uint8_t *addr, uint8_t len)
+{
+	CRC->POL = 0x31;
+	CRC->INIT = 0;
+	CRC->CR = CRC_CR_POLYSIZE_1 | CRC_CR_REV_IN_0 | CRC_CR_REV_OUT | CRC_CR_RESET;
+
+	while (len--)
+	{
+		OW_CRC_DR_WRITE8(*addr++);
+	}
+
+	return (uint8_t) CRC->DR;
+}
+
+#if ONEWIRE_CRC16
+uint16_t OW_HwCrc16(const uint8_t* input, uint16_t len, uint16_t crc)
+{
+	CRC->POL = 0x8005;
+	CRC->INIT = __RBIT(crc) >> 16;
+	CRC->CR = CRC_CR_POLYSIZE_0 | CRC_CR_REV_IN_0 | CRC_CR_REV_OUT | CRC_CR_RESET;
+
+	while (len--)
+	{
+		OW_CRC_DR_WRITE8(*input++);
+	}
+
+	return (uint16_t) CRC->DR;
+}
+#endif
+#endif
+
+#endif
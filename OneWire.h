@@ -1,145 +1,428 @@
-/*
- * OneWire.h
- *
- *  Created on: Dec 16, 2020
- *      Author: Andriy Honcharenko
- */
-
-#ifndef INC_ONEWIRE_H_
-#define INC_ONEWIRE_H_
-
-#include "main.h"
-#include <stdbool.h>
-#include <string.h>
-
-// You can exclude certain features from OneWire.  In theory, this
-// might save some space.  In practice, the compiler automatically
-// removes unused code (technically, the linker, using -fdata-sections
-// and -ffunction-sections when compiling, and Wl,--gc-sections
-// when linking), so most of these will not result in any code size
-// reduction.  Well, unless you try to use the missing features
-// and redesign your program to not need them!  ONEWIRE_CRC8_TABLE
-// is the exception, because it selects a fast but large algorithm
-// or a small but slow algorithm.
-
-// you can exclude onewire_search by defining that to 0
-#ifndef ONEWIRE_SEARCH
-#define ONEWIRE_SEARCH 1
-#endif
-
-// You can exclude CRC checks altogether by defining this to 0
-#ifndef ONEWIRE_CRC
-#define ONEWIRE_CRC 1
-#endif
-
-// Select the table-lookup method of computing the 8-bit CRC
-// by setting this to 1.  The lookup table enlarges code size by
-// about 250 bytes.  It does NOT consume RAM (but did in very
-// old versions of OneWire).  If you disable this, a slower
-// but very compact algorithm is used.
-#ifndef ONEWIRE_CRC8_TABLE
-#define ONEWIRE_CRC8_TABLE 1
-#endif
-
-// You can allow 16-bit CRC checks by defining this to 1
-// (Note that ONEWIRE_CRC must also be 1.)
-#ifndef ONEWIRE_CRC16
-#define ONEWIRE_CRC16 1
-#endif
-
-#define OW_OK				1
-#define OW_ERROR			2
-#define OW_NO_DEVICE		3
-
-#define OW_0				0x00
-#define OW_1				0xff
-#define OW_R_1				0xff
-
-#define OW_SEND_RESET		1
-#define OW_NO_RESET			2
-
-#define OW_NO_READ			0xff
-#define OW_READ_SLOT		0xff
-
-typedef struct{
-	UART_HandleTypeDef* huart;
-	unsigned char ROM_NO[8];
-	#if ONEWIRE_SEARCH
-	// global search state
-	uint8_t LastDiscrepancy;
-	uint8_t LastFamilyDiscrepancy;
-	bool LastDeviceFlag;
-	#endif
-}OneWire_HandleTypeDef;
-
-HAL_StatusTypeDef OneWire(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart);
-HAL_StatusTypeDef OW_Begin(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart);
-
-// Perform a 1-Wire reset cycle. Returns 1 if a device responds
-// with a presence pulse.  Returns 0 if there is no device or the
-// bus is shorted or otherwise held low for more than 250uS
-uint8_t OW_Reset(OneWire_HandleTypeDef* ow);
-uint8_t OW_Send(OneWire_HandleTypeDef* ow, uint8_t *command, uint8_t cLen, uint8_t *data, uint8_t dLen, uint8_t readStart);
-
-#if ONEWIRE_SEARCH
-// Clear the search state so that if will start from the beginning again.
-void OW_ResetSearch(OneWire_HandleTypeDef* ow);
-
-// Setup the search to find the device type 'family_code' on the next call
-// to search(*newAddr) if it is present.
-void OW_TargetSearch(OneWire_HandleTypeDef* ow, uint8_t family_code);
-
-// Look for the next device. Returns 1 if a new address has been
-// returned. A zero might mean that the bus is shorted, there are
-// no devices, or you have already retrieved all of them.  It
-// might be a good idea to check the CRC to make sure you didn't
-// get garbage.  The order is deterministic. You will always get
-// the same devices in the same order.
-uint8_t OW_Search(OneWire_HandleTypeDef* ow, uint8_t *buf, uint8_t num);
-#endif
-
-#if ONEWIRE_CRC
-// Compute a Dallas Semiconductor 8 bit CRC, these are used in the
-// ROM and scratchpad registers.
-uint8_t OW_Crc8(const uint8_t *addr, uint8_t len);
-
-#if ONEWIRE_CRC16
-// Compute the 1-Wire CRC16 and compare it against the received CRC.
-// Example usage (reading a DS2408):
-//    // Put everything in a buffer so we can compute the CRC easily.
-//    uint8_t buf[13];
-//    buf[0] = 0xF0;    // Read PIO Registers
-//    buf[1] = 0x88;    // LSB address
-//    buf[2] = 0x00;    // MSB address
-//    WriteBytes(net, buf, 3);    // Write 3 cmd bytes
-//    ReadBytes(net, buf+3, 10);  // Read 6 data bytes, 2 0xFF, 2 CRC16
-//    if (!CheckCRC16(buf, 11, &buf[11])) {
-//        // Handle error.
-//    }
-//
-// @param input - Array of bytes to checksum.
-// @param len - How many bytes to use.
-// @param inverted_crc - The two CRC16 bytes in the received data.
-//                       This should just point into the received data,
-//                       *not* at a 16-bit integer.
-// @param crc - The crc starting value (optional)
-// @return True, iff the CRC matches.
-bool OW_CheckCrc16(const uint8_t* input, uint16_t len, const uint8_t* inverted_crc, uint16_t crc);
-
-// Compute a Dallas Semiconductor 16 bit CRC.  This is required to check
-// the integrity of data received from many 1-Wire devices.  Note that the
-// CRC computed here is *not* what you'll get from the 1-Wire network,
-// for two reasons:
-//   1) The CRC is transmitted bitwise inverted.
-//   2) Depending on the endian-ness of your processor, the binary
-//      representation of the two-byte return value may have a different
-//      byte order than the two bytes you get from 1-Wire.
-// @param input - Array of bytes to checksum.
-// @param len - How many bytes to use.
-// @param crc - The crc starting value (optional)
-// @return The CRC16, as defined by Dallas Semiconductor.
-uint16_t OW_Crc16(const uint8_t* input, uint16_t len, uint16_t crc);
-#endif
-#endif
-
-#endif /* INC_ONEWIRE_H_ */
+/*
+ * OneWire.h
+ *
+ *  Created on: Dec 16, 2020
+ *      Author: Andriy Honcharenko
+ */
+
+#ifndef INC_ONEWIRE_H_
+#define INC_ONEWIRE_H_
+
+#include "main.h"
+#include <stdbool.h>
+#include <string.h>
+
+// You can exclude certain features from OneWire.  In theory, this
+// might save some space.  In practice, the compiler automatically
+// removes unused code (technically, the linker, using -fdata-sections
+// and -ffunction-sections when compiling, and Wl,--gc-sections
+// when linking), so most of these will not result in any code size
+// reduction.  Well, unless you try to use the missing features
+// and redesign your program to not need them!  ONEWIRE_CRC8_TABLE
+// is the exception, because it selects a fast but large algorithm
+// or a small but slow algorithm.
+
+// you can exclude onewire_search by defining that to 0
+#ifndef ONEWIRE_SEARCH
+#define ONEWIRE_SEARCH 1
+#endif
+
+// You can exclude CRC checks altogether by defining this to 0
+#ifndef ONEWIRE_CRC
+#define ONEWIRE_CRC 1
+#endif
+
+// Select the table-lookup method of computing the 8-bit CRC
+// by setting this to 1.  The lookup table enlarges code size by
+// about 250 bytes.  It does NOT consume RAM (but did in very
+// old versions of OneWire).  If you disable this, a slower
+// but very compact algorithm is used.  2 selects a full 256 entry
+// table: 256 bytes of flash, one lookup per byte instead of two.
+#ifndef ONEWIRE_CRC8_TABLE
+#define ONEWIRE_CRC8_TABLE 1
+#endif
+
+// You can allow 16-bit CRC checks by defining this to 1
+// (Note that ONEWIRE_CRC must also be 1.)
+#ifndef ONEWIRE_CRC16
+#define ONEWIRE_CRC16 1
+#endif
+
+// Compute the 16-bit CRC with a 256 entry table (512 bytes of flash)
+// instead of the parity trick by setting this to 1.
+#ifndef ONEWIRE_CRC16_TABLE
+#define ONEWIRE_CRC16_TABLE 0
+#endif
+
+// Let OW_SetCrcHooks() route OW_Crc8/OW_Crc16 to other implementations,
+// e.g. OW_HwCrc8/OW_HwCrc16 on parts whose CRC unit has a programmable
+// polynomial.
+#ifndef ONEWIRE_CRC_HOOK
+#define ONEWIRE_CRC_HOOK 0
+#endif
+
+// OW_Send expands the whole command into one buffer and clocks it out
+// as a single TX/RX DMA transfer, then decodes the read window.  Define
+// this to 0 to go back to arming the DMA once per byte, which needs no
+// extra RAM but leaves gaps on the wire between bytes.
+#ifndef ONEWIRE_SINGLE_DMA
+#define ONEWIRE_SINGLE_DMA 1
+#endif
+
+// Size in bit slots (8 per byte) of the slot buffer built into every
+// OneWire_HandleTypeDef.  Commands longer than the buffer are split into
+// several DMA bursts.  The default covers a Match ROM scratchpad read
+// (0x55, 8 ROM bytes, 0xBE and 9 read slots).  OW_SetSlotBuffer() can
+// swap in a larger caller-owned buffer; define this to 8 to keep the
+// handle small in that case.  Must be at least 8.
+#ifndef ONEWIRE_SLOT_BUF_SIZE
+#if ONEWIRE_SINGLE_DMA
+#define ONEWIRE_SLOT_BUF_SIZE (19 * 8)
+#else
+#define ONEWIRE_SLOT_BUF_SIZE 8
+#endif
+#endif
+
+// Switch between the reset (9600) and data (115200) baud rates by
+// writing precomputed BRR values instead of re-running
+// HAL_HalfDuplex_Init twice per reset.  Define this to 0 on parts whose
+// UART cannot be reprogrammed that way.
+#ifndef ONEWIRE_FAST_BAUD
+#define ONEWIRE_FAST_BAUD 1
+#endif
+
+// Count DMA starts, bit slots and time spent on the bus per handle.
+// Timing uses OW_STATS_TIMESTAMP(), the DWT cycle counter by default.
+// Cortex-M0 parts have no DWT, so define OW_STATS_TIMESTAMP() and
+// OW_STATS_CLOCK to a free running timer and its frequency there.
+#ifndef ONEWIRE_STATS
+#define ONEWIRE_STATS 0
+#endif
+
+#ifndef OW_STATS_TIMESTAMP
+#define OW_STATS_TIMESTAMP()	(DWT->CYCCNT)
+#endif
+
+#ifndef OW_STATS_CLOCK
+#define OW_STATS_CLOCK			(SystemCoreClock)
+#endif
+
+// Interrupt driven transaction engine (OW_Queue...() and OW_AsyncStart()).
+// To use it, forward HAL_UART_TxCpltCallback, HAL_UART_RxCpltCallback and
+// HAL_UART_ErrorCallback to OW_TxCpltCallback, OW_RxCpltCallback and
+// OW_ErrorCallback for every OneWire handle.
+#ifndef ONEWIRE_ASYNC
+#define ONEWIRE_ASYNC 1
+#endif
+
+// Number of operations that can be queued for one asynchronous run
+#ifndef ONEWIRE_ASYNC_QUEUE
+#define ONEWIRE_ASYNC_QUEUE 8
+#endif
+
+#define OW_OK				1
+#define OW_ERROR			2
+#define OW_NO_DEVICE		3
+#define OW_BUSY				4
+
+#define OW_0				0x00
+#define OW_1				0xff
+#define OW_R_1				0xff
+
+#define OW_SEND_RESET		1
+#define OW_NO_RESET			2
+
+#define OW_NO_READ			0xff
+#define OW_READ_SLOT		0xff
+
+// Asynchronous operations
+#define OW_OP_RESET			0
+#define OW_OP_WRITE			1
+#define OW_OP_READ			2
+#define OW_OP_TRIPLET		3
+
+// Running CRC modes (OW_StreamCrc)
+#define OW_CRC_NONE			0
+#define OW_CRC_8			1
+#define OW_CRC_16			2
+
+// Bits of a triplet result
+#define OW_TRIPLET_ID		0x01	// first read slot
+#define OW_TRIPLET_CMP		0x02	// second (complement) read slot
+#define OW_TRIPLET_DIR		0x04	// direction bit written back
+
+#if ONEWIRE_STATS
+typedef struct{
+	// number of OW_Send transactions
+	uint32_t transactions;
+	// number of TX/RX DMA pairs armed, resets included
+	uint32_t dmaStarts;
+	// number of bit slots clocked at the data baud rate
+	uint32_t slots;
+	// OW_STATS_TIMESTAMP() ticks spent transferring bit slots
+	uint64_t busyTicks;
+	// number of reset pulses and OW_STATS_TIMESTAMP() ticks spent in them
+	uint32_t resets;
+	uint64_t resetTicks;
+}OneWire_StatsTypeDef;
+#endif
+
+#if ONEWIRE_ASYNC
+// Called from interrupt context when an asynchronous run ends, with
+// OW_OK, OW_NO_DEVICE (no presence pulse) or OW_ERROR (UART error).
+typedef void OW_AsyncCallback(void* context, uint8_t status);
+
+typedef struct{
+	uint8_t type;
+	// bytes to write or read, or the preferred triplet direction
+	uint8_t len;
+	// bytes to write (OW_OP_WRITE)
+	const uint8_t *tx;
+	// read buffer (OW_OP_READ) or triplet result (OW_OP_TRIPLET)
+	uint8_t *rx;
+}OneWire_OpTypeDef;
+#endif
+
+typedef struct{
+	UART_HandleTypeDef* huart;
+	// ROM of the last device found by OW_Search
+	unsigned char ROM_NO[8];
+	#if ONEWIRE_FAST_BAUD
+	// baud rate divisors for the reset pulse and for data slots
+	uint32_t brrReset;
+	uint32_t brrData;
+	#endif
+	// bit slots of the transfer currently on the wire, points to
+	// slotStorage unless OW_SetSlotBuffer() supplied another buffer
+	uint8_t *slotBuf;
+	uint16_t slotBufSize;
+	uint8_t slotStorage[ONEWIRE_SLOT_BUF_SIZE];
+	#if ONEWIRE_STATS
+	OneWire_StatsTypeDef stats;
+	#endif
+	#if ONEWIRE_ASYNC
+	// asynchronous transaction engine state
+	OneWire_OpTypeDef asyncQueue[ONEWIRE_ASYNC_QUEUE];
+	uint8_t asyncCount;
+	uint8_t asyncIndex;
+	uint8_t asyncPhase;
+	volatile bool asyncTxDone;
+	volatile bool asyncRxDone;
+	volatile uint8_t asyncStatus;
+	OW_AsyncCallback *asyncCallback;
+	void *asyncContext;
+	#endif
+	#if ONEWIRE_CRC
+	// running CRC over the bytes read, see OW_StreamCrc
+	uint8_t crcMode;
+	uint16_t crc;
+	#endif
+	#if ONEWIRE_SEARCH
+	// global search state
+	uint8_t LastDiscrepancy;
+	uint8_t LastFamilyDiscrepancy;
+	bool LastDeviceFlag;
+	// next ROM bit of a search spread over OW_SearchStep calls (1-64),
+	// 0 between devices, and the last discrepancy taken as 1 so far
+	uint8_t searchBit;
+	uint8_t searchLastOne;
+	// family code set by OW_TargetSearch, 0 for all devices
+	uint8_t searchFamily;
+	// Search ROM or Conditional Search (OW_ResetAlarmSearch)
+	uint8_t searchCommand;
+	#endif
+}OneWire_HandleTypeDef;
+
+HAL_StatusTypeDef OneWire(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart);
+HAL_StatusTypeDef OW_Begin(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart);
+
+// Use 'buf' ('size' slots, at least 8) as the bit slot buffer of the
+// handle, so that longer commands go out in a single DMA burst.  The
+// buffer must be reachable by the DMA and stay valid while the handle
+// is in use.  Pass NULL to go back to the built-in buffer.  Call after
+// OW_Begin(), which selects the built-in buffer.
+void OW_SetSlotBuffer(OneWire_HandleTypeDef* ow, uint8_t *buf, uint16_t size);
+
+// Perform a 1-Wire reset cycle. Returns 1 if a device responds
+// with a presence pulse.  Returns 0 if there is no device or the
+// bus is shorted or otherwise held low for more than 250uS
+uint8_t OW_Reset(OneWire_HandleTypeDef* ow);
+
+// Send a command and optionally read part of the answer.  'sendReset' is
+// OW_SEND_RESET or OW_NO_RESET.  Returns OW_OK, or OW_NO_DEVICE when the
+// reset got no presence pulse.
+uint8_t OW_Send(OneWire_HandleTypeDef* ow, uint8_t sendReset, uint8_t *command, uint8_t cLen, uint8_t *data, uint8_t dLen, uint8_t readStart);
+
+// Like OW_Send, but 'frame' ('frameSlots' bit slots, see OW_ToSlots) is
+// clocked out before the command without being encoded again, e.g. a
+// Match ROM prefix prepared once per device.  'readStart' counts command
+// bytes only.
+uint8_t OW_SendFrame(OneWire_HandleTypeDef* ow, uint8_t sendReset, const uint8_t *frame, uint8_t frameSlots, uint8_t *command, uint8_t cLen, uint8_t *data, uint8_t dLen, uint8_t readStart);
+
+// Expand 'len' bytes into len * 8 bit slots for OW_SendFrame.
+void OW_ToSlots(const uint8_t *bytes, uint8_t len, uint8_t *slots);
+
+// Issue a single read slot without a reset and return the bit read.
+// Devices busy with a conversion or an EEPROM copy answer 0 until done.
+uint8_t OW_ReadBit(OneWire_HandleTypeDef* ow);
+
+#if ONEWIRE_ASYNC
+// Queue operations for the next asynchronous run.  Buffers must stay
+// valid until the run has finished.  Return OW_OK, OW_BUSY while a run
+// is in progress or OW_ERROR when the queue is full or a write or read
+// has no bytes.
+uint8_t OW_QueueReset(OneWire_HandleTypeDef* ow);
+uint8_t OW_QueueWrite(OneWire_HandleTypeDef* ow, const uint8_t *data, uint8_t len);
+uint8_t OW_QueueRead(OneWire_HandleTypeDef* ow, uint8_t *data, uint8_t len);
+
+// Read a bit and its complement, then write back the bit if they
+// differ or 'direction' if both read 0 (a search discrepancy).  The
+// OW_TRIPLET_... bits of the outcome are stored in *result.  Nothing
+// is written when both slots read 1 (no device took part).
+uint8_t OW_QueueTriplet(OneWire_HandleTypeDef* ow, uint8_t direction, uint8_t *result);
+
+// Run the queued operations in the background.  The queue is emptied
+// when the run ends; 'callback' may be NULL if the caller polls
+// OW_AsyncStatus() instead.  Do not call the blocking functions on the
+// same handle while a run is in progress.
+uint8_t OW_AsyncStart(OneWire_HandleTypeDef* ow, OW_AsyncCallback *callback, void* context);
+
+// OW_BUSY while a run is in progress, otherwise the result of the last run.
+uint8_t OW_AsyncStatus(OneWire_HandleTypeDef* ow);
+
+// Forward the HAL UART callbacks here.  Transfers of other UARTs and
+// blocking transfers are ignored.
+void OW_TxCpltCallback(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart);
+void OW_RxCpltCallback(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart);
+void OW_ErrorCallback(OneWire_HandleTypeDef* ow, UART_HandleTypeDef* huart);
+#endif
+
+#if ONEWIRE_STATS
+// Clear the transfer statistics of the handle.
+void OW_ResetStats(OneWire_HandleTypeDef* ow);
+
+// Time in microseconds spent in transfers while no bit slot was on
+// the wire (DMA set-up and gaps between bursts).
+uint32_t OW_GetIdleMicros(OneWire_HandleTypeDef* ow);
+
+// Average duration of OW_Reset() in microseconds, baud switching included.
+uint32_t OW_GetResetMicros(OneWire_HandleTypeDef* ow);
+#endif
+
+#if ONEWIRE_SEARCH
+// Clear the search state so that if will start from the beginning again.
+void OW_ResetSearch(OneWire_HandleTypeDef* ow);
+
+// Clear the search state like OW_ResetSearch, and let the following
+// OW_SearchNext/OW_SearchStep calls find only devices with an alarm
+// condition (Conditional Search, 0xEC).
+void OW_ResetAlarmSearch(OneWire_HandleTypeDef* ow);
+
+// Setup OW_SearchNext/OW_SearchStep to find only devices of type
+// 'family_code', walking just that branch of the ROM tree, until the next
+// OW_ResetSearch.  Keeps the kind of search (all devices or alarms only)
+// of the last reset.  OW_Search always finds all devices.
+void OW_TargetSearch(OneWire_HandleTypeDef* ow, uint8_t family_code);
+
+// Look for the next device. Returns 1 if a new address has been
+// returned. A zero might mean that the bus is shorted, there are
+// no devices, or you have already retrieved all of them.  It
+// might be a good idea to check the CRC to make sure you didn't
+// get garbage.  The order is deterministic. You will always get
+// the same devices in the same order.
+uint8_t OW_Search(OneWire_HandleTypeDef* ow, uint8_t *buf, uint8_t num);
+
+// Find one device per call, continuing the search of the handle, and copy
+// its ROM code to newAddr.  Returns false once all devices were found; call
+// OW_ResetSearch() to start over.  Works for any number of devices.
+bool OW_SearchNext(OneWire_HandleTypeDef* ow, uint8_t *newAddr);
+
+// Same search, spread over several calls: each call handles at most
+// 'maxTriplets' ROM bits.  Returns OW_BUSY until the device is complete,
+// then OW_OK with its ROM code in newAddr, or OW_NO_DEVICE at the end.
+// LastDeviceFlag is then set unless a bus error cut the search short; a
+// bus without presence pulse counts as searched.
+// Keep other traffic off the bus while a device is in progress.
+uint8_t OW_SearchStep(OneWire_HandleTypeDef* ow, uint8_t *newAddr, uint8_t maxTriplets);
+
+// Check that the device with ROM code 'addr' answers the search.  Does
+// not disturb a search in progress.
+bool OW_Verify(OneWire_HandleTypeDef* ow, const uint8_t *addr);
+#endif
+
+#if ONEWIRE_CRC
+// Compute a Dallas Semiconductor 8 bit CRC, these are used in the
+// ROM and scratchpad registers.
+uint8_t OW_Crc8(const uint8_t *addr, uint8_t len);
+
+// Keep a running CRC (OW_CRC_8 or OW_CRC_16, starting from 'seed') over
+// every byte read by the following transactions, updated while the slots
+// are decoded.  OW_CRC_NONE stops it.
+void OW_StreamCrc(OneWire_HandleTypeDef* ow, uint8_t mode, uint16_t seed);
+
+// The running CRC so far, e.g. to give up early on a long read.
+uint16_t OW_GetStreamCrc(OneWire_HandleTypeDef* ow);
+
+// True if the bytes read since OW_StreamCrc, ending with the CRC the
+// device sent (inverted for CRC16), check out.
+bool OW_StreamCrcOk(OneWire_HandleTypeDef* ow);
+
+#if ONEWIRE_CRC_HOOK
+typedef uint8_t OW_Crc8Hook(const uint8_t *addr, uint8_t len);
+typedef uint16_t OW_Crc16Hook(const uint8_t* input, uint16_t len, uint16_t crc);
+
+// Compute OW_Crc8 and OW_Crc16 with these functions from now on, NULL
+// goes back to the built-in one.  A hook shared with other code must
+// save and restore whatever state it changes.
+void OW_SetCrcHooks(OW_Crc8Hook *crc8, OW_Crc16Hook *crc16);
+
+#if defined(CRC_CR_POLYSIZE)
+// Hooks for the CRC unit.  Enable its clock (__HAL_RCC_CRC_CLK_ENABLE())
+// first; they reprogram polynomial, seed and mode on every call.
+uint8_t OW_HwCrc8(const uint8_t *addr, uint8_t len);
+#if ONEWIRE_CRC16
+uint16_t OW_HwCrc16(const uint8_t* input, uint16_t len, uint16_t crc);
+#endif
+#endif
+#endif
+
+#if ONEWIRE_CRC16
+// Compute the 1-Wire CRC16 and compare it against the received CRC.
+// Example usage (reading a DS2408):
+//    // Put everything in a buffer so we can compute the CRC easily.
+//    uint8_t buf[13];
+//    buf[0] = 0xF0;    // Read PIO Registers
+//    buf[1] = 0x88;    // LSB address
+//    buf[2] = 0x00;    // MSB address
+//    WriteBytes(net, buf, 3);    // Write 3 cmd bytes
+//    ReadBytes(net, buf+3, 10);  // Read 6 data bytes, 2 0xFF, 2 CRC16
+//    if (!CheckCRC16(buf, 11, &buf[11])) {
+//        // Handle error.
+//    }
+//
+// @param input - Array of bytes to checksum.
+// @param len - How many bytes to use.
+// @param inverted_crc - The two CRC16 bytes in the received data.
+//                       This should just point into the received data,
+//                       *not* at a 16-bit integer.
+// @param crc - The crc starting value (optional)
+// @return True, iff the CRC matches.
+bool OW_CheckCrc16(const uint8_t* input, uint16_t len, const uint8_t* inverted_crc, uint16_t crc);
+
+// Compute a Dallas Semiconductor 16 bit CRC.  This is required to check
+// the integrity of data received from many 1-Wire devices.  Note that the
+// CRC computed here is *not* what you'll get from the 1-Wire network,
+// for two reasons:
+//   1) The CRC is transmitted bitwise inverted.
+//   2) Depending on the endian-ness of your processor, the binary
+//      representation of the two-byte return value may have a different
+//      byte order than the two bytes you get from 1-Wire.
+// @param input - Array of bytes to checksum.
+// @param len - How many bytes to use.
+// @param crc - The crc starting value (optional)
+// @return The CRC16, as defined by Dallas Semiconductor.
+uint16_t OW_Crc16(const uint8_t* input, uint16_t len, uint16_t crc);
+#endif
+#endif
+
+#endif /* INC_ONEWIRE_H_ */
@@ -0,0 +1,249 @@
+/*
+ * OneWire_CrcCheck.c
+ *
+ * Host check of the CRC code in OneWire.c: OW_Crc8 and OW_Crc16 in the
+ * table variant selected, and OW_HwCrc8/OW_HwCrc16 against a model of the
+ * CRC unit with programmable polynomial (POL, INIT, CR, byte writes to
+ * DR), all compared with plain bitwise loops, and a microbenchmark in ns
+ * per byte over 9, 64, 128 and 256 byte buffers.  Not part of the
+ * firmware, compiled only with ONEWIRE_HOST_CHECK defined, once for each
+ * table option:
+ *
+ *   for t8 in 0 1 2; do for t16 in 0 1; do
+ *     cc -O2 -DONEWIRE_HOST_CHECK -DONEWIRE_CRC_HOOK=1 \
+ *        -DONEWIRE_CRC8_TABLE=$t8 -DONEWIRE_CRC16_TABLE=$t16 -Ihost -I. \
+ *        -o crc_check OneWire_CrcCheck.c OneWire.c host/BusModel.c && ./crc_check
+ *   done; done
+ *
+ * The ns/byte of OW_HwCrc8/16 is that of the model, a bitwise loop in C,
+ * not of the unit, which takes one AHB write per byte.
+ *
+ * Returns 0 if every CRC matches.
+ */
+#ifdef ONEWIRE_HOST_CHECK
+
+#include "OneWire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if !ONEWIRE_CRC || !ONEWIRE_CRC16 || !ONEWIRE_CRC_HOOK
+#error "build with ONEWIRE_CRC, ONEWIRE_CRC16 and ONEWIRE_CRC_HOOK"
+#endif
+
+static CRC_TypeDef hostCrc;
+static uint32_t crcState;
+
+static uint32_t Reflect(uint32_t value, int bits)
+{
+	return __RBIT(value) >> (32 - bits);
+}
+
+static int PolySize(void)
+{
+	static const int sizes[4] = { 32, 16, 8, 7 };
+
+	return sizes[(hostCrc.CR & CRC_CR_POLYSIZE) / CRC_CR_POLYSIZE_0];
+}
+
+static uint32_t PolyMask(void)
+{
+	int bits = PolySize();
+
+	return (bits == 32) ? 0xFFFFFFFFu : ((1u << bits) - 1);
+}
+
+// DR reads the state, reflected over the polynomial size with REV_OUT
+static void UpdateDr(void)
+{
+	hostCrc.DR = (hostCrc.CR & CRC_CR_REV_OUT) ? Reflect(crcState, PolySize()) : crcState;
+}
+
+// the unit: a RESET written to CR loads INIT and clears itself
+CRC_TypeDef *HostCrc_Unit(void)
+{
+	if (hostCrc.CR & CRC_CR_RESET)
+	{
+		hostCrc.CR &= ~CRC_CR_RESET;
+		crcState = hostCrc.INIT & PolyMask();
+		UpdateDr();
+	}
+	return &hostCrc;
+}
+
+// every byte written to DR is shifted in MSB first (bit reversed with
+// REV_IN)
+void HostCrc_Write8(uint8_t data)
+{
+	int bits = PolySize();
+	uint32_t mask = PolyMask();
+
+	HostCrc_Unit();
+	if (hostCrc.CR & CRC_CR_REV_IN)
+		data = (uint8_t) Reflect(data, 8);
+
+	for (int i = 7; i >= 0; i--)
+	{
+		uint32_t feedback = ((crcState >> (bits - 1)) ^ (data >> i)) & 1;
+
+		crcState = (crcState << 1) & mask;
+		if (feedback)
+			crcState ^= hostCrc.POL & mask;
+	}
+	UpdateDr();
+}
+
+// the 1-Wire CRCs one bit at a time, as in Maxim Application Note 27
+static uint8_t RefCrc8(const uint8_t *addr, int len)
+{
+	uint8_t crc = 0;
+
+	while (len--)
+	{
+		crc ^= *addr++;
+		for (int i = 0; i < 8; i++)
+			crc = (crc & 1) ? (crc >> 1) ^ 0x8C : crc >> 1;
+	}
+	return crc;
+}
+
+static uint16_t RefCrc16(const uint8_t *input, int len, uint16_t crc)
+{
+	while (len--)
+	{
+		crc ^= *input++;
+		for (int i = 0; i < 8; i++)
+			crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+	}
+	return crc;
+}
+
+static unsigned failures;
+
+static void Check(bool ok, const char *what)
+{
+	printf("%-52s %s\n", what, ok ? "ok" : "FAILED");
+	if (!ok)
+		failures++;
+}
+
+static double NowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#define BENCH_BYTES		(256 * 1024)
+#define CHECK_ROUNDS	64
+
+static uint8_t buf[512];
+static uint8_t benchBytes[BENCH_BYTES];
+static volatile uint16_t benchSink;
+
+static uint8_t SoftCrc8(const uint8_t *addr, uint8_t len)
+{
+	return OW_Crc8(addr, len);
+}
+
+static uint16_t SoftCrc16(const uint8_t *input, uint16_t len, uint16_t crc)
+{
+	return OW_Crc16(input, len, crc);
+}
+
+// ns per byte of computing the CRC over every 'size' byte buffer in turn
+static void Bench(const char *name, OW_Crc8Hook *crc8, OW_Crc16Hook *crc16)
+{
+	static const uint16_t sizes[4] = { 9, 64, 128, 256 };
+
+	printf("%-12s", name);
+	for (int s = 0; s < 4; s++)
+	{
+		// OW_Crc8 takes at most 255 bytes
+		uint16_t size = sizes[s], size8 = (size > 255) ? 255 : size;
+		uint16_t acc = 0;
+		double start;
+
+		start = NowNs();
+		for (uint32_t i = 0; i + size8 <= BENCH_BYTES; i += size8)
+			acc += crc8(&benchBytes[i], (uint8_t) size8);
+		double ns8 = (NowNs() - start) / (BENCH_BYTES - BENCH_BYTES % size8);
+
+		start = NowNs();
+		for (uint32_t i = 0; i + size <= BENCH_BYTES; i += size)
+			acc += crc16(&benchBytes[i], size, 0);
+		double ns16 = (NowNs() - start) / (BENCH_BYTES - BENCH_BYTES % size);
+
+		benchSink = acc;
+		printf("  %3u: %5.2f/%5.2f", size, ns8, ns16);
+	}
+	printf("  ns/byte (crc8/crc16)\n");
+}
+
+int main(void)
+{
+	// Application Note 27: the ROM 02 1C B8 01 00 00 00 has CRC A2;
+	// "123456789" has the CRC16 BB3D (sent inverted by the devices)
+	static const uint8_t rom[7] = { 0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00 };
+	static const uint8_t digits[9] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+	bool ok8 = true, okHw8 = true, ok16 = true, okHw16 = true, okHooks = true;
+
+	printf("ONEWIRE_CRC8_TABLE %d, ONEWIRE_CRC16_TABLE %d:\n", ONEWIRE_CRC8_TABLE, ONEWIRE_CRC16_TABLE);
+
+	Check(OW_Crc8(rom, 7) == 0xA2 && OW_HwCrc8(rom, 7) == 0xA2, "known CRC8 (Application Note 27)");
+	Check(OW_Crc16(digits, 9, 0) == 0xBB3D && OW_HwCrc16(digits, 9, 0) == 0xBB3D, "known CRC16");
+
+	// every length, random bytes and seeds
+	srand(1);
+	for (int r = 0; r < CHECK_ROUNDS; r++)
+	{
+		for (size_t i = 0; i < sizeof(buf); i++)
+			buf[i] = (uint8_t) rand();
+
+		for (int len = 0; len < 256; len++)
+		{
+			uint8_t ref = RefCrc8(buf, len);
+
+			ok8 &= OW_Crc8(buf, (uint8_t) len) == ref;
+			okHw8 &= OW_HwCrc8(buf, (uint8_t) len) == ref;
+		}
+
+		for (int len = 0; len <= (int) sizeof(buf); len++)
+		{
+			uint16_t seed = (uint16_t) rand();
+			uint16_t ref = RefCrc16(buf, len, seed);
+
+			ok16 &= OW_Crc16(buf, (uint16_t) len, seed) == ref;
+			okHw16 &= OW_HwCrc16(buf, (uint16_t) len, seed) == ref;
+		}
+	}
+	Check(ok8, "OW_Crc8 = bitwise, lengths 0..255");
+	Check(okHw8, "OW_HwCrc8 = bitwise, lengths 0..255");
+	Check(ok16, "OW_Crc16 = bitwise, lengths 0..512, any seed");
+	Check(okHw16, "OW_HwCrc16 = bitwise, lengths 0..512, any seed");
+
+	// routed through the hooks, as a firmware would set them up
+	OW_SetCrcHooks(OW_HwCrc8, OW_HwCrc16);
+	for (int len = 0; len < 256; len++)
+	{
+		uint16_t crc16 = ~RefCrc16(buf, len, 0);
+		uint8_t inverted[2] = { (uint8_t) crc16, (uint8_t) (crc16 >> 8) };
+
+		okHooks &= OW_Crc8(buf, (uint8_t) len) == RefCrc8(buf, len);
+		okHooks &= OW_CheckCrc16(buf, (uint16_t) len, inverted, 0);
+	}
+	OW_SetCrcHooks(NULL, NULL);
+	Check(okHooks, "OW_Crc8, OW_CheckCrc16 through OW_SetCrcHooks");
+
+	for (uint32_t i = 0; i < BENCH_BYTES; i++)
+		benchBytes[i] = (uint8_t) (i * 37 + 11);
+	Bench("OW_Crc*", SoftCrc8, SoftCrc16);
+	Bench("OW_HwCrc*", OW_HwCrc8, OW_HwCrc16);
+	printf("(OW_HwCrc* on the model of the unit, not its speed)\n");
+
+	printf("%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
+
+#endif /* ONEWIRE_HOST_CHECK */
@@ -0,0 +1,61 @@
+/*
+ * OneWire_Slots.h
+ *
+ * Bit slot encode/decode kernels of OneWire.c.  Every UART byte is one
+ * 1-Wire slot, OW_1/OW_R_1 (0xFF) or OW_0 (0x00), least significant bit
+ * first.  Kept apart from OneWire.c, without HAL dependencies, so that
+ * OneWire_SlotsCheck.c can test them on the host.
+ */
+
+#ifndef INC_ONEWIRE_SLOTS_H_
+#define INC_ONEWIRE_SLOTS_H_
+
+#include <stdint.h>
+#include <string.h>
+
+// The kernels move four slots at a time as a little endian word, as all
+// STM32 cores are.  A big endian build would reverse the slot order.
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "OneWire_Slots.h: the bit slot kernels need a little endian target"
+#endif
+
+// Slots of a nibble, least significant bit first, as a little endian word
+static const uint32_t OW_NibbleSlots[16] = {
+	0x00000000, 0x000000FF, 0x0000FF00, 0x0000FFFF,
+	0x00FF0000, 0x00FF00FF, 0x00FFFF00, 0x00FFFFFF,
+	0xFF000000, 0xFF0000FF, 0xFF00FF00, 0xFF00FFFF,
+	0xFFFF0000, 0xFFFF00FF, 0xFFFFFF00, 0xFFFFFFFF
+};
+
+// Bits of four slots loaded as a little endian word, a slot reads 1 only
+// if its echo is OW_R_1.  ~w has a zero byte for every such slot; the
+// carry trick flags those bytes in bit 7 without a loop, the multiply
+// gathers the four flags into bits 21-24.
+static inline uint8_t OW_SlotsToNibble(uint32_t w)
+{
+	uint32_t x = ~w;
+	uint32_t y = ((x & 0x7F7F7F7F) + 0x7F7F7F7F) | x;
+	uint32_t bits = ~y & 0x80808080;
+
+	return (uint8_t) ((((bits >> 7) * 0x00204081) >> 21) & 0x0F);
+}
+
+// Expands a byte into 8 slots
+static inline void OW_ToBits(uint8_t owByte, uint8_t *owBits)
+{
+	memcpy(&owBits[0], &OW_NibbleSlots[owByte & 0x0F], 4);
+	memcpy(&owBits[4], &OW_NibbleSlots[owByte >> 4], 4);
+}
+
+// Collects a byte from the echo of 8 slots, any echo but 0xFF is a 0
+static inline uint8_t OW_ToByte(const uint8_t *owBits)
+{
+	uint32_t lo, hi;
+
+	memcpy(&lo, &owBits[0], 4);
+	memcpy(&hi, &owBits[4], 4);
+
+	return OW_SlotsToNibble(lo) | (OW_SlotsToNibble(hi) << 4);
+}
+
+#endif /* INC_ONEWIRE_SLOTS_H_ */
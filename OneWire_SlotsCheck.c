@@ -0,0 +1,181 @@
+/*
+ * OneWire_SlotsCheck.c
+ *
+ * Host check of the bit slot kernels in OneWire_Slots.h: exhaustive
+ * equivalence with the per-bit loops they replaced, and a microbenchmark
+ * in ns per byte.  Not part of the firmware, everything is compiled only
+ * with ONEWIRE_SLOTS_CHECK defined:
+ *
+ *   cc -O2 -DONEWIRE_SLOTS_CHECK -o slots_check OneWire_SlotsCheck.c
+ *   ./slots_check          (add "full" for all 2^32 four slot words)
+ *
+ * Returns 0 if the kernels match.
+ */
+#ifdef ONEWIRE_SLOTS_CHECK
+
+#include "OneWire_Slots.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define REF_OW_0	0x00
+#define REF_OW_1	0xff
+#define REF_OW_R_1	0xff
+
+// the loops OW_ToBits and OW_ToByte used before the kernels
+static void RefToBits(uint8_t owByte, uint8_t *owBits)
+{
+	uint8_t i;
+	for (i = 0; i < 8; i++)
+	{
+		if (owByte & 0x01)
+		{
+			*owBits = REF_OW_1;
+		}
+		else
+		{
+			*owBits = REF_OW_0;
+		}
+		owBits++;
+		owByte = owByte >> 1;
+	}
+}
+
+static uint8_t RefToByte(const uint8_t *owBits)
+{
+	uint8_t owByte, i;
+	owByte = 0;
+	for (i = 0; i < 8; i++)
+	{
+		owByte = owByte >> 1;
+		if (*owBits == REF_OW_R_1)
+		{
+			owByte |= 0x80;
+		}
+		owBits++;
+	}
+
+	return owByte;
+}
+
+static unsigned long failures;
+
+static void CheckDecode(const uint8_t *slots)
+{
+	if (OW_ToByte(slots) != RefToByte(slots) && failures++ < 10)
+	{
+		printf("decode mismatch: %02X %02X %02X %02X %02X %02X %02X %02X\n",
+				slots[0], slots[1], slots[2], slots[3], slots[4], slots[5], slots[6], slots[7]);
+	}
+}
+
+static double NowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#define BENCH_BYTES	4096
+#define BENCH_ROUNDS	2000
+
+static uint8_t benchBytes[BENCH_BYTES];
+static uint8_t benchSlots[BENCH_BYTES * 8];
+static volatile uint8_t benchSink;
+
+static void Bench(const char *name, void (*toBits)(uint8_t, uint8_t *), uint8_t (*toByte)(const uint8_t *))
+{
+	double start = NowNs();
+	for (int r = 0; r < BENCH_ROUNDS; r++)
+	{
+		benchBytes[r % BENCH_BYTES] ^= (uint8_t) r;
+		for (int i = 0; i < BENCH_BYTES; i++)
+			toBits(benchBytes[i], &benchSlots[i * 8]);
+	}
+	double encode = (NowNs() - start) / ((double) BENCH_ROUNDS * BENCH_BYTES);
+
+	uint8_t acc = 0;
+	start = NowNs();
+	for (int r = 0; r < BENCH_ROUNDS; r++)
+	{
+		benchSlots[r % sizeof(benchSlots)] ^= (uint8_t) r;
+		for (int i = 0; i < BENCH_BYTES; i++)
+			acc += toByte(&benchSlots[i * 8]);
+	}
+	double decode = (NowNs() - start) / ((double) BENCH_ROUNDS * BENCH_BYTES);
+	benchSink = acc;
+
+	printf("%-8s encode %5.2f ns/byte  decode %5.2f ns/byte\n", name, encode, decode);
+}
+
+static void KernelToBits(uint8_t owByte, uint8_t *owBits)
+{
+	OW_ToBits(owByte, owBits);
+}
+
+static uint8_t KernelToByte(const uint8_t *owBits)
+{
+	return OW_ToByte(owBits);
+}
+
+int main(int argc, char **argv)
+{
+	uint8_t slots[8], ref[8];
+	// slot echoes standing for all others: a clean 0, a 1 disturbed in
+	// the last bit, in the first bit, and a clean 1
+	static const uint8_t echoes[4] = { 0x00, 0xFE, 0x7F, 0xFF };
+
+	// encode: every byte
+	for (int b = 0; b < 256; b++)
+	{
+		OW_ToBits((uint8_t) b, slots);
+		RefToBits((uint8_t) b, ref);
+		if (memcmp(slots, ref, 8) != 0 && failures++ < 10)
+			printf("encode mismatch: %02X\n", b);
+	}
+
+	// decode: each of the 4^8 = 65536 combinations of the echoes above
+	for (uint32_t v = 0; v < 65536; v++)
+	{
+		for (int i = 0; i < 8; i++)
+			slots[i] = echoes[(v >> (2 * i)) & 3];
+		CheckDecode(slots);
+	}
+
+	// decode: every echo value in every slot, the others clean
+	for (int p = 0; p < 8; p++)
+	{
+		for (int e = 0; e < 256; e++)
+		{
+			for (int b = 0; b < 256; b++)
+			{
+				RefToBits((uint8_t) b, slots);
+				slots[p] = (uint8_t) e;
+				CheckDecode(slots);
+			}
+		}
+	}
+
+	// decode: every four slot word, the same in both nibbles
+	if (argc > 1 && strcmp(argv[1], "full") == 0)
+	{
+		uint32_t w = 0;
+		do
+		{
+			memcpy(&slots[0], &w, 4);
+			memcpy(&slots[4], &w, 4);
+			CheckDecode(slots);
+		} while (++w != 0);
+	}
+
+	printf("equivalence: %s (%lu mismatches)\n", failures ? "FAILED" : "ok", failures);
+
+	for (int i = 0; i < BENCH_BYTES; i++)
+		benchBytes[i] = (uint8_t) (i * 37 + 11);
+	Bench("loops", RefToBits, RefToByte);
+	Bench("kernels", KernelToBits, KernelToByte);
+
+	return failures ? 1 : 0;
+}
+
+#endif /* ONEWIRE_SLOTS_CHECK */
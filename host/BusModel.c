@@ -0,0 +1,585 @@
+/*
+ * BusModel.c
+ *
+ * The HAL functions of main.h for the host checks, with the devices of
+ * BusModel.h on the bus.
+ */
+#ifdef ONEWIRE_HOST_CHECK
+
+#include "BusModel.h"
+#include <string.h>
+
+#define RESET_BAUD		9600
+
+// one 10 bit UART frame: a slot at 115200 baud, a reset at 9600 baud
+#define SLOT_NS			86806u
+#define RESET_NS		1041667u
+// arming a TX/RX DMA pair through the HAL, roughly, on a 72 MHz part
+#define DMA_SETUP_NS	6000u
+
+// device states between two resets
+#define DEV_IDLE		0
+#define DEV_ROM_CMD		1
+#define DEV_SEARCH		2
+#define DEV_MATCH		3
+#define DEV_FUNCTION	4
+#define DEV_SEND		5
+#define DEV_RECEIVE		6
+#define DEV_CONVERT		7
+
+// ROM and function commands
+#define CMD_MATCH_ROM	0x55
+#define CMD_SKIP_ROM	0xCC
+#define CMD_SEARCH_ROM	0xF0
+#define CMD_ALARM_SEARCH	0xEC
+#define CMD_READ_SCRATCH	0xBE
+#define CMD_WRITE_SCRATCH	0x4E
+#define CMD_COPY_SCRATCH	0x48
+#define CMD_RECALL_EEPROM	0xB8
+#define CMD_READ_POWER	0xB4
+#define CMD_CONVERT_T	0x44
+
+typedef struct
+{
+	uint8_t rom[8];
+	uint8_t scratchPad[9];
+	// TH, TL and the configuration register (not on DS18S20)
+	uint8_t eeprom[3];
+	bool parasite;
+	// on the bus; an unplugged device ignores resets and slots
+	bool present;
+	// temperature in 1/16 degrees C the next conversion measures
+	int16_t temperature;
+	// a conversion and the clock of the model it is done at
+	bool converting;
+	uint64_t convertDone;
+	// the last conversion was at or above TH or at or below TL
+	bool alarm;
+	// the scratchpad is sent with a bit of the temperature flipped
+	bool corrupt;
+	uint8_t state;
+	// bits of the byte being received, and the byte so far
+	uint8_t bits;
+	uint8_t command;
+	// ROM bit of the search and its step: bit, complement, direction.
+	// searchBit also counts the ROM bits of a Match ROM
+	uint8_t searchBit;
+	uint8_t searchStep;
+	// bytes the device sends, and the next bit of them
+	uint8_t out[9];
+	uint8_t outLen;
+	uint16_t outBit;
+	// scratchpad bytes received by Write Scratchpad
+	uint8_t received;
+} BusDevice;
+
+static USART_TypeDef hostUsart;
+UART_HandleTypeDef hostUart = { .Instance = &hostUsart };
+GPIO_TypeDef hostGpioC;
+DWT_Type hostDwt;
+CoreDebug_Type hostCoreDebug;
+uint32_t SystemCoreClock = 72000000;
+
+static BusDevice devices[BUS_MAX_DEVICES];
+static uint16_t deviceCount;
+static uint32_t resets;
+static uint32_t slots;
+static uint32_t dmaStarts;
+static uint32_t delayMillis;
+static uint64_t nanos;
+
+static uint8_t Crc8(const uint8_t *data, uint8_t len)
+{
+	uint8_t crc = 0;
+
+	while (len--)
+	{
+		uint8_t inbyte = *data++;
+
+		for (uint8_t i = 8; i; i--)
+		{
+			uint8_t mix = (crc ^ inbyte) & 0x01;
+			crc >>= 1;
+			if (mix)
+				crc ^= 0x8C;
+			inbyte >>= 1;
+		}
+	}
+
+	return crc;
+}
+
+// conversion time of the resolution the device is set to, typical
+// rather than the maximum the library waits
+static uint32_t ConvertMillis(const BusDevice *device)
+{
+	if (device->rom[0] == 0x10)
+		return 600;
+
+	switch (device->scratchPad[4])
+	{
+	case 0x1F:
+		return 80;
+	case 0x3F:
+		return 160;
+	case 0x5F:
+		return 320;
+	default:
+		return 600;
+	}
+}
+
+// a finished conversion puts the temperature into the scratchpad, in
+// 1/2 degrees for the DS18S20, with the low bits the resolution does not
+// give cleared for the others, and sets the alarm flag from the whole
+// degrees against TH and TL
+static void FinishConversion(BusDevice *device)
+{
+	int16_t t = device->temperature;
+
+	if (!device->converting || nanos < device->convertDone)
+		return;
+	device->converting = false;
+	device->alarm = (t >> 4) >= (int8_t) device->scratchPad[2] || (t >> 4) <= (int8_t) device->scratchPad[3];
+
+	if (device->rom[0] == 0x10)
+	{
+		t >>= 3;
+		device->scratchPad[6] = 0x0C;
+		device->scratchPad[7] = 0x10;
+	}
+	else
+	{
+		t &= ~((1 << (3 - ((device->scratchPad[4] >> 5) & 0x03))) - 1);
+	}
+
+	device->scratchPad[0] = (uint8_t) t;
+	device->scratchPad[1] = (uint8_t) (t >> 8);
+	device->scratchPad[8] = Crc8(device->scratchPad, 8);
+}
+
+// moves the clock of the model on, and the cycle counter with it
+static void Advance(uint64_t ns)
+{
+	nanos += ns;
+	hostDwt.CYCCNT = (uint32_t) (nanos * (SystemCoreClock / 1000000) / 1000);
+}
+
+static uint8_t RomBit(const BusDevice *device, uint8_t bit)
+{
+	return (device->rom[bit >> 3] >> (bit & 0x07)) & 0x01;
+}
+
+static void Send(BusDevice *device, const uint8_t *data, uint8_t len)
+{
+	memcpy(device->out, data, len);
+	device->outLen = len;
+	device->outBit = 0;
+	device->state = DEV_SEND;
+}
+
+// level the device drives in the next slot, 1 = released
+static uint8_t DeviceOutput(const BusDevice *device)
+{
+	switch (device->state)
+	{
+	case DEV_SEARCH:
+		if (device->searchStep == 0)
+			return RomBit(device, device->searchBit);
+		if (device->searchStep == 1)
+			return !RomBit(device, device->searchBit);
+		return 1;
+
+	case DEV_SEND:
+		if (device->outBit >= device->outLen * 8)
+			return 1;
+		return (device->out[device->outBit >> 3] >> (device->outBit & 0x07)) & 0x01;
+
+	// read slots during a conversion are 0 until it is done, parasite
+	// powered devices cannot drive the bus then
+	case DEV_CONVERT:
+		return device->parasite || nanos >= device->convertDone;
+
+	default:
+		return 1;
+	}
+}
+
+static void RomCommand(BusDevice *device, uint8_t command)
+{
+	switch (command)
+	{
+	// Alarm Search: only devices with the alarm flag set take part
+	case CMD_ALARM_SEARCH:
+		if (!device->alarm)
+		{
+			device->state = DEV_IDLE;
+			break;
+		}
+		// fall through
+	case CMD_SEARCH_ROM:
+		device->state = DEV_SEARCH;
+		device->searchBit = 0;
+		device->searchStep = 0;
+		break;
+
+	case CMD_MATCH_ROM:
+		device->state = DEV_MATCH;
+		device->searchBit = 0;
+		break;
+
+	case CMD_SKIP_ROM:
+		device->state = DEV_FUNCTION;
+		break;
+
+	default:
+		device->state = DEV_IDLE;
+		break;
+	}
+}
+
+// bytes of TH, TL and configuration register the device holds
+static uint8_t ConfigBytes(const BusDevice *device)
+{
+	return (device->rom[0] == 0x10) ? 2 : 3;
+}
+
+static void FunctionCommand(BusDevice *device, uint8_t command)
+{
+	uint8_t parasite = device->parasite ? 0x00 : 0xFF;
+
+	switch (command)
+	{
+	case CMD_READ_SCRATCH:
+		FinishConversion(device);
+		Send(device, device->scratchPad, 9);
+		if (device->corrupt)
+			device->out[0] ^= 0x10;
+		break;
+
+	case CMD_CONVERT_T:
+		device->converting = true;
+		device->convertDone = nanos + ConvertMillis(device) * 1000000ull;
+		device->state = DEV_CONVERT;
+		break;
+
+	case CMD_WRITE_SCRATCH:
+		device->state = DEV_RECEIVE;
+		device->received = 0;
+		break;
+
+	case CMD_COPY_SCRATCH:
+		memcpy(device->eeprom, &device->scratchPad[2], ConfigBytes(device));
+		device->state = DEV_IDLE;
+		break;
+
+	case CMD_RECALL_EEPROM:
+		memcpy(&device->scratchPad[2], device->eeprom, ConfigBytes(device));
+		device->scratchPad[8] = Crc8(device->scratchPad, 8);
+		device->state = DEV_IDLE;
+		break;
+
+	// parasite powered devices pull the read slots low
+	case CMD_READ_POWER:
+		Send(device, &parasite, 1);
+		break;
+
+	default:
+		device->state = DEV_IDLE;
+		break;
+	}
+}
+
+// a byte of Write Scratchpad: TH, TL, then the configuration register
+static void Receive(BusDevice *device, uint8_t data)
+{
+	device->scratchPad[2 + device->received] = data;
+	device->scratchPad[8] = Crc8(device->scratchPad, 8);
+
+	if (++device->received == ConfigBytes(device))
+		device->state = DEV_IDLE;
+}
+
+// the device sees the bus level of a slot
+static void DeviceInput(BusDevice *device, uint8_t level)
+{
+	switch (device->state)
+	{
+	case DEV_ROM_CMD:
+	case DEV_FUNCTION:
+	case DEV_RECEIVE:
+		device->command |= level << device->bits;
+		if (++device->bits < 8)
+			break;
+
+		device->bits = 0;
+		if (device->state == DEV_ROM_CMD)
+			RomCommand(device, device->command);
+		else if (device->state == DEV_FUNCTION)
+			FunctionCommand(device, device->command);
+		else
+			Receive(device, device->command);
+		device->command = 0;
+		break;
+
+	case DEV_MATCH:
+		if (level != RomBit(device, device->searchBit))
+			device->state = DEV_IDLE;
+		else if (++device->searchBit == 64)
+			device->state = DEV_FUNCTION;
+		break;
+
+	case DEV_SEARCH:
+		if (device->searchStep < 2)
+		{
+			device->searchStep++;
+			break;
+		}
+
+		// the master took the other branch
+		if (level != RomBit(device, device->searchBit))
+		{
+			device->state = DEV_IDLE;
+			break;
+		}
+
+		device->searchStep = 0;
+		if (++device->searchBit == 64)
+			device->state = DEV_FUNCTION;
+		break;
+
+	case DEV_SEND:
+		if (device->outBit < device->outLen * 8)
+			device->outBit++;
+		break;
+
+	default:
+		break;
+	}
+}
+
+static uint8_t Reset(void)
+{
+	bool presence = false;
+
+	resets++;
+	Advance(RESET_NS);
+
+	for (uint16_t i = 0; i < deviceCount; i++)
+	{
+		if (!devices[i].present)
+			continue;
+
+		presence = true;
+		FinishConversion(&devices[i]);
+		devices[i].state = DEV_ROM_CMD;
+		devices[i].bits = 0;
+		devices[i].command = 0;
+	}
+
+	// a presence pulse corrupts the echo of 0xF0
+	return presence ? 0xE0 : 0xF0;
+}
+
+static uint8_t Slot(uint8_t tx)
+{
+	uint8_t level = (tx == 0xFF);
+
+	slots++;
+	Advance(SLOT_NS);
+
+	for (uint16_t i = 0; i < deviceCount; i++)
+	{
+		if (devices[i].present)
+			level &= DeviceOutput(&devices[i]);
+	}
+
+	for (uint16_t i = 0; i < deviceCount; i++)
+	{
+		if (devices[i].present)
+			DeviceInput(&devices[i], level);
+	}
+
+	if (tx != 0xFF)
+		return tx;
+
+	// a device holding the bus low cuts the start bit short
+	return level ? 0xFF : 0xF8;
+}
+
+void Bus_Clear(void)
+{
+	deviceCount = 0;
+	resets = 0;
+	slots = 0;
+	dmaStarts = 0;
+	delayMillis = 0;
+}
+
+bool Bus_AddDevice(uint8_t family, uint32_t serial)
+{
+	// power-on scratchpad: 85 C, TH 75, TL 70, 12 bits
+	static const uint8_t powerOn[8] = { 0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10 };
+
+	if (deviceCount >= BUS_MAX_DEVICES)
+		return false;
+
+	BusDevice *device = &devices[deviceCount++];
+
+	memset(device, 0, sizeof(*device));
+	device->rom[0] = family;
+	memcpy(&device->rom[1], &serial, 4);
+	device->rom[7] = Crc8(device->rom, 7);
+
+	memcpy(device->scratchPad, powerOn, 8);
+	device->scratchPad[8] = Crc8(device->scratchPad, 8);
+	memcpy(device->eeprom, &powerOn[2], 3);
+	device->temperature = 25 * 16;
+	device->present = true;
+
+	return true;
+}
+
+void Bus_SetTemperature(uint16_t index, int16_t temperature)
+{
+	devices[index].temperature = temperature;
+}
+
+void Bus_CorruptScratchPad(uint16_t index, bool corrupt)
+{
+	devices[index].corrupt = corrupt;
+}
+
+void Bus_SetParasite(uint16_t index, bool parasite)
+{
+	devices[index].parasite = parasite;
+}
+
+void Bus_SetPresent(uint16_t index, bool present)
+{
+	devices[index].present = present;
+	devices[index].state = DEV_IDLE;
+}
+
+const uint8_t* Bus_Rom(uint16_t index)
+{
+	return devices[index].rom;
+}
+
+const uint8_t* Bus_ScratchPad(uint16_t index)
+{
+	return devices[index].scratchPad;
+}
+
+const uint8_t* Bus_Eeprom(uint16_t index)
+{
+	return devices[index].eeprom;
+}
+
+uint32_t Bus_Resets(void)
+{
+	return resets;
+}
+
+uint32_t Bus_Slots(void)
+{
+	return slots;
+}
+
+uint32_t Bus_DmaStarts(void)
+{
+	return dmaStarts;
+}
+
+uint32_t Bus_DelayMillis(void)
+{
+	return delayMillis;
+}
+
+uint64_t Bus_Micros(void)
+{
+	return nanos / 1000;
+}
+
+HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart)
+{
+	huart->Instance->BRR = huart->Init.BaudRate;
+	huart->Instance->CR1 |= USART_CR1_UE;
+	huart->gState = HAL_UART_STATE_READY;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+	huart->rxBuf = pData;
+	huart->rxLen = Size;
+	huart->gState = HAL_UART_STATE_BUSY_RX;
+
+	return HAL_OK;
+}
+
+// the whole transfer is done before this returns, the echo goes to the
+// receive buffer, which may be the transmit buffer itself
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+	if (Size == 0)
+		return HAL_ERROR;
+
+	dmaStarts++;
+	Advance(DMA_SETUP_NS);
+
+	for (uint16_t i = 0; i < Size; i++)
+	{
+		uint8_t tx = pData[i];
+		uint8_t echo = (huart->Init.BaudRate == RESET_BAUD) ? Reset() : Slot(tx);
+
+		if (huart->rxBuf != NULL && i < huart->rxLen)
+			huart->rxBuf[i] = echo;
+	}
+
+	huart->rxBuf = NULL;
+	huart->gState = HAL_UART_STATE_READY;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart)
+{
+	huart->rxBuf = NULL;
+	huart->gState = HAL_UART_STATE_READY;
+
+	return HAL_OK;
+}
+
+HAL_UART_StateTypeDef HAL_UART_GetState(UART_HandleTypeDef *huart)
+{
+	return huart->gState;
+}
+
+uint32_t HAL_GetTick(void)
+{
+	return (uint32_t) (nanos / 1000000);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	delayMillis += Delay;
+	Advance((uint64_t) Delay * 1000000);
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+	(void) GPIOx;
+	(void) GPIO_Init;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin, GPIO_PinState PinState)
+{
+	if (PinState == GPIO_PIN_SET)
+		GPIOx->ODR |= GPIO_Pin;
+	else
+		GPIOx->ODR &= ~GPIO_Pin;
+}
+
+#endif /* ONEWIRE_HOST_CHECK */
@@ -0,0 +1,66 @@
+/*
+ * BusModel.h
+ *
+ * Devices on the 1-Wire bus of the host checks, behind the UART of
+ * main.h: every byte sent at 9600 baud is a reset, every other byte a
+ * slot.  The devices answer the reset, Search ROM, Alarm Search, Match
+ * ROM and Skip ROM, then Convert T, Read and Write Scratchpad, Copy
+ * Scratchpad, Recall EEPROM and Read Power Supply; any other command
+ * leaves them idle until the next reset.  The model keeps a clock: every
+ * slot and reset takes its UART frame time, every DMA start a fixed
+ * set-up time, every conversion the typical time of its resolution.
+ */
+
+#ifndef HOST_BUS_MODEL_H_
+#define HOST_BUS_MODEL_H_
+
+#include "main.h"
+#include <stdbool.h>
+
+#define BUS_MAX_DEVICES		512
+
+extern UART_HandleTypeDef hostUart;
+
+// removes all devices
+void Bus_Clear(void);
+
+// adds a device with a valid ROM code of 'family' and 'serial', returns
+// false if the bus is full
+bool Bus_AddDevice(uint8_t family, uint32_t serial);
+
+// ROM code of device 'index' in the order added
+const uint8_t* Bus_Rom(uint16_t index);
+
+// makes device 'index' parasite powered or not (the default)
+void Bus_SetParasite(uint16_t index, bool parasite);
+
+// unplugs device 'index' or plugs it back in; it keeps its memory and
+// waits for the next reset
+void Bus_SetPresent(uint16_t index, bool present);
+
+// temperature in 1/16 degrees C device 'index' measures from the next
+// Convert T on, 25 C by default.  The conversion sets the alarm flag of
+// the device if the whole degrees are at or above TH or at or below TL
+void Bus_SetTemperature(uint16_t index, int16_t temperature);
+
+// makes device 'index' send its scratchpad with a bit of the temperature
+// flipped and the CRC left as it was, as noise on the bus would
+void Bus_CorruptScratchPad(uint16_t index, bool corrupt);
+
+// scratchpad of device 'index', the power-on values until changed, and
+// the TH, TL and configuration register in its EEPROM
+const uint8_t* Bus_ScratchPad(uint16_t index);
+const uint8_t* Bus_Eeprom(uint16_t index);
+
+// resets, slots and TX/RX DMA starts since Bus_Clear
+uint32_t Bus_Resets(void);
+uint32_t Bus_Slots(void);
+uint32_t Bus_DmaStarts(void);
+
+// milliseconds waited in HAL_Delay since Bus_Clear
+uint32_t Bus_DelayMillis(void);
+
+// clock of the model in microseconds, HAL_GetTick and HAL_Delay use it
+uint64_t Bus_Micros(void);
+
+#endif /* HOST_BUS_MODEL_H_ */
@@ -0,0 +1,157 @@
+/*
+ * ConfigureCheck.c
+ *
+ * Host benchmark of the bus time it takes to set the resolution of every
+ * device: the per-device DT_SetResolution loop DT_SetAllResolution used
+ * to run, against DT_SetAllResolution and DT_ConfigureAll with their
+ * single broadcast Copy Scratchpad.  Reports slots, resets, HAL_Delay
+ * milliseconds and the total bus time of the model for 5 and 40 devices.
+ * Compiled only with ONEWIRE_HOST_CHECK defined, from the directory above:
+ *
+ *   cc -O2 -DONEWIRE_HOST_CHECK -Ihost -I. -o configure_check \
+ *      host/ConfigureCheck.c host/BusModel.c OneWire.c DallasTemperature.c
+ *   ./configure_check
+ *
+ * Returns 0 if every way configured every device and the broadcast ones
+ * waited for the EEPROM once.
+ */
+#ifdef ONEWIRE_HOST_CHECK
+
+#include "BusModel.h"
+#include "OneWire.h"
+#include "DallasTemperature.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_DEVICES		40
+#define RESOLUTION		9
+#define CONFIG_9_BIT	0x1F
+
+typedef struct{
+	uint32_t slots;
+	uint32_t resets;
+	uint32_t delayMillis;
+	uint64_t micros;
+}BusCost;
+
+static OneWire_HandleTypeDef ow;
+static DallasTemperature_HandleTypeDef dt;
+static DallasTemperature_DeviceTypeDef table[MAX_DEVICES];
+static unsigned failures;
+
+static void Check(bool ok, const char *what)
+{
+	printf("%-60s %s\n", what, ok ? "ok" : "FAILED");
+	if (!ok)
+		failures++;
+}
+
+static BusCost Cost(void)
+{
+	BusCost cost = { Bus_Slots(), Bus_Resets(), Bus_DelayMillis(), Bus_Micros() };
+
+	return cost;
+}
+
+// a fresh bus of 12 bit devices, found and probed
+static void Start(uint16_t devices)
+{
+	Bus_Clear();
+	for (uint16_t i = 0; i < devices; i++)
+		Bus_AddDevice(DS18B20MODEL, 0x2000 + i * 0x1357);
+
+	OW_Begin(&ow, &hostUart);
+	DT_SetOneWire(&dt, &ow);
+	DT_SetDeviceTable(&dt, table, MAX_DEVICES);
+	DT_Begin(&dt);
+}
+
+// the loop DT_SetAllResolution ran before the broadcast copy, on the
+// bus: for every device DT_GetResolution and DT_IsConnected_ScratchPad
+// read the scratchpad, DT_WriteScratchPad wrote it and copied it
+static void PerDevice(uint8_t config)
+{
+	for (uint16_t i = 0; i < dt.devices; i++)
+	{
+		const uint8_t *address = dt.device[i].address;
+		ScratchPad scratchPad;
+
+		DT_ReadScratchPad(&dt, address, scratchPad);
+		if (scratchPad[4] == config)
+			continue;
+
+		DT_ReadScratchPad(&dt, address, scratchPad);
+		scratchPad[4] = config;
+		DT_WriteScratchPad(&dt, address, scratchPad);
+	}
+}
+
+// every device holds the resolution in its scratchpad and EEPROM
+static bool Configured(uint16_t devices)
+{
+	for (uint16_t i = 0; i < devices; i++)
+	{
+		if (Bus_ScratchPad(i)[4] != CONFIG_9_BIT || Bus_Eeprom(i)[2] != CONFIG_9_BIT)
+			return false;
+	}
+
+	return true;
+}
+
+static void Report(const char *what, BusCost start, uint16_t devices, uint32_t maxDelay)
+{
+	BusCost end = Cost();
+	char line[80];
+
+	printf("  %-30s %6lu slots %4lu resets %5lu ms delay %5lu ms bus\n", what,
+			(unsigned long) (end.slots - start.slots), (unsigned long) (end.resets - start.resets),
+			(unsigned long) (end.delayMillis - start.delayMillis), (unsigned long) ((end.micros - start.micros) / 1000));
+
+	snprintf(line, sizeof(line), "    all %u devices configured", devices);
+	Check(Configured(devices), line);
+
+	if (maxDelay != 0)
+		Check(end.delayMillis - start.delayMillis <= maxDelay, "    one EEPROM wait");
+}
+
+static void Run(uint16_t devices)
+{
+	BusCost start;
+	bool verified;
+
+	printf("%u devices, 12 to 9 bits:\n", devices);
+
+	Start(devices);
+	start = Cost();
+	PerDevice(CONFIG_9_BIT);
+	Report("per device (before)", start, devices, 0);
+
+	// the shadow filled by DT_Begin would spare the reads, drop it
+	Start(devices);
+	DT_InvalidateConfig(&dt, NULL);
+	start = Cost();
+	DT_SetAllResolution(&dt, RESOLUTION);
+	Report("DT_SetAllResolution", start, devices, 20);
+
+	Start(devices);
+	start = Cost();
+	DT_ConfigureAll(&dt, 75, 70, RESOLUTION, false);
+	Report("DT_ConfigureAll", start, devices, 20);
+
+	Start(devices);
+	start = Cost();
+	verified = DT_ConfigureAll(&dt, 75, 70, RESOLUTION, true);
+	Report("DT_ConfigureAll, verify", start, devices, 20);
+	Check(verified, "    read back and verified");
+}
+
+int main(void)
+{
+	Run(5);
+	Run(MAX_DEVICES);
+
+	printf("%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
+
+#endif /* ONEWIRE_HOST_CHECK */
@@ -0,0 +1,254 @@
+/*
+ * DeviceTableCheck.c
+ *
+ * Host check of the device table of DallasTemperature.c on a modelled bus
+ * of 256 devices: tables smaller than, as large as and larger than the
+ * bus, for DT_Rescan and DT_UpdateDevices.  On buses of 1 and 256 devices
+ * both must stay within the slots of one search pass per device and use
+ * the same stack, measured as the high watermark of a painted stack
+ * (gcc -fstack-usage gives the frames of the single functions).  On a
+ * bus with a device of another family DT_GetDS18Count must follow every
+ * way the table changes.
+ * Compiled only with ONEWIRE_HOST_CHECK defined, from the directory
+ * above:
+ *
+ *   cc -O2 -DONEWIRE_HOST_CHECK -Ihost -I. -o table_check \
+ *      host/DeviceTableCheck.c host/BusModel.c OneWire.c DallasTemperature.c
+ *   ./table_check
+ *
+ * Returns 0 if all checks pass.
+ */
+#ifdef ONEWIRE_HOST_CHECK
+
+#include "BusModel.h"
+#include "OneWire.h"
+#include "DallasTemperature.h"
+#include <stdio.h>
+#include <string.h>
+#include <ucontext.h>
+
+#define BUS_DEVICES		256
+// reset, Search ROM command and 64 triplets
+#define SEARCH_SLOTS	(8 + 64 * 3)
+#define STACK_BYTES		(64 * 1024)
+#define STACK_PAINT		0xA5
+
+static OneWire_HandleTypeDef ow;
+static DallasTemperature_HandleTypeDef dt;
+static DallasTemperature_DeviceTypeDef table[BUS_DEVICES + 44];
+// the devices in the order of a plain OW_SearchNext enumeration
+static uint8_t searchOrder[BUS_DEVICES][8];
+static unsigned failures;
+
+static uint8_t stack[STACK_BYTES];
+static ucontext_t mainContext, runContext;
+static void (*stackRun)(void);
+
+static void Check(bool ok, const char *what)
+{
+	printf("%-60s %s\n", what, ok ? "ok" : "FAILED");
+	if (!ok)
+		failures++;
+}
+
+// the table holds the first 'count' devices of the search, nothing else
+static bool TableIsSearchPrefix(uint16_t count)
+{
+	if (DT_GetDeviceCount(&dt) != count)
+		return false;
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		CurrentDeviceAddress address;
+
+		if (!DT_GetAddress(&dt, address, i) || memcmp(address, searchOrder[i], 8) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+static void CheckRescan(uint16_t capacity, bool overflow, const char *what)
+{
+	DT_SetDeviceTable(&dt, table, capacity);
+	uint16_t found = DT_Rescan(&dt);
+	uint16_t expected = (capacity < BUS_DEVICES) ? capacity : BUS_DEVICES;
+
+	Check(found == expected && DT_GetDeviceOverflow(&dt) == overflow && TableIsSearchPrefix(expected), what);
+}
+
+static void CheckUpdate(uint16_t capacity, bool overflow, const char *what)
+{
+	uint16_t changes;
+
+	DT_SetDeviceTable(&dt, table, capacity);
+	changes = DT_UpdateDevices(&dt);
+	uint16_t expected = (capacity < BUS_DEVICES) ? capacity : BUS_DEVICES;
+
+	Check(changes == expected && DT_GetDeviceOverflow(&dt) == overflow && TableIsSearchPrefix(expected), what);
+
+	// a second update finds nothing new
+	changes = DT_UpdateDevices(&dt);
+	Check(changes == 0 && DT_GetDeviceOverflow(&dt) == overflow && TableIsSearchPrefix(expected), "  and a second update changes nothing");
+}
+
+static void StackEntry(void)
+{
+	stackRun();
+}
+
+// bytes of a painted stack 'run' wrote to, the entry of the context
+// included
+static size_t StackUse(void (*run)(void))
+{
+	size_t untouched = 0;
+
+	memset(stack, STACK_PAINT, sizeof(stack));
+	getcontext(&runContext);
+	runContext.uc_stack.ss_sp = stack;
+	runContext.uc_stack.ss_size = sizeof(stack);
+	runContext.uc_link = &mainContext;
+	stackRun = run;
+	makecontext(&runContext, StackEntry, 0);
+	swapcontext(&mainContext, &runContext);
+
+	// the stack grows down from the end of the buffer
+	while (untouched < sizeof(stack) && stack[untouched] == STACK_PAINT)
+		untouched++;
+
+	return sizeof(stack) - untouched;
+}
+
+static void RunRescan(void)
+{
+	DT_Rescan(&dt);
+}
+
+static void RunUpdate(void)
+{
+	DT_UpdateDevices(&dt);
+}
+
+typedef struct{
+	size_t rescan;
+	size_t update;
+	size_t updateSame;
+}StackUsage;
+
+// slots and resets per device and the stack of DT_Rescan, of
+// DT_UpdateDevices into an empty table (probing every device) and of one
+// that changes nothing, on a bus of 'devices'
+static StackUsage CheckCost(uint16_t devices)
+{
+	StackUsage usage;
+	char line[80];
+	uint32_t slots, resets;
+
+	printf("%u device(s):\n", devices);
+	Bus_Clear();
+	for (uint32_t i = 0; i < devices; i++)
+		Bus_AddDevice(DS18B20MODEL, i * 2654435761u);
+	DT_SetDeviceTable(&dt, table, sizeof(table) / sizeof(table[0]));
+
+	slots = Bus_Slots();
+	resets = Bus_Resets();
+	usage.rescan = StackUse(RunRescan);
+	printf("  DT_Rescan: %lu slots per device, %lu bytes of stack\n",
+			(unsigned long) ((Bus_Slots() - slots) / devices), (unsigned long) usage.rescan);
+	snprintf(line, sizeof(line), "  DT_Rescan: %u found, <= %u slots and 1 reset each", devices, SEARCH_SLOTS);
+	Check(dt.devices == devices && Bus_Slots() - slots <= (uint32_t) SEARCH_SLOTS * devices
+			&& Bus_Resets() - resets <= devices, line);
+
+	DT_SetDeviceTable(&dt, table, sizeof(table) / sizeof(table[0]));
+	usage.update = StackUse(RunUpdate);
+
+	slots = Bus_Slots();
+	resets = Bus_Resets();
+	usage.updateSame = StackUse(RunUpdate);
+	printf("  DT_UpdateDevices: %lu slots per device, %lu/%lu bytes of stack (empty table/no change)\n",
+			(unsigned long) ((Bus_Slots() - slots) / devices), (unsigned long) usage.update, (unsigned long) usage.updateSame);
+	snprintf(line, sizeof(line), "  DT_UpdateDevices: <= %u slots and 1 reset each", SEARCH_SLOTS);
+	Check(dt.devices == devices && Bus_Slots() - slots <= (uint32_t) SEARCH_SLOTS * devices
+			&& Bus_Resets() - resets <= devices, line);
+
+	return usage;
+}
+
+// DT_GetDS18Count after DT_Rescan, DT_UpdateDevices and DT_CheckDevices
+// on 3 sensors and a DS2408, which is none
+static void CheckSensorCount(void)
+{
+	Bus_Clear();
+	for (uint32_t i = 0; i < 3; i++)
+		Bus_AddDevice(DS18B20MODEL, 0x4000 + i);
+	Bus_AddDevice(0x29, 0x4100);
+
+	printf("DT_GetDS18Count, 3 sensors and a DS2408:\n");
+	DT_SetOneWire(&dt, &ow);
+	DT_Rescan(&dt);
+	Check(DT_GetDeviceCount(&dt) == 4 && DT_GetDS18Count(&dt) == 3, "  DT_Rescan without DT_Begin: 3");
+
+	Bus_SetPresent(0, false);
+	Bus_SetPresent(2, false);
+	Check(DT_UpdateDevices(&dt) == 2 && DT_GetDS18Count(&dt) == 1, "  2 unplugged, DT_UpdateDevices: 1");
+
+	Bus_SetPresent(0, true);
+	Bus_SetPresent(2, true);
+	Check(DT_UpdateDevices(&dt) == 2 && DT_GetDS18Count(&dt) == 3, "  plugged back in, DT_UpdateDevices: 3");
+
+	Bus_SetPresent(1, false);
+	Check(DT_CheckDevices(&dt, false) == 1 && DT_GetDS18Count(&dt) == 2, "  1 unplugged, DT_CheckDevices: 2");
+	Bus_SetPresent(1, true);
+
+	DT_Begin(&dt);
+	DT_SetDeviceTable(&dt, table, sizeof(table) / sizeof(table[0]));
+	Check(DT_GetDS18Count(&dt) == 0, "  DT_Begin, DT_SetDeviceTable: 0");
+	DT_UpdateDevices(&dt);
+	Check(DT_GetDS18Count(&dt) == 3, "    then DT_UpdateDevices: 3");
+}
+
+int main(void)
+{
+	uint16_t n = 0;
+
+	Bus_Clear();
+	for (uint32_t i = 0; i < BUS_DEVICES; i++)
+		Bus_AddDevice(DS18B20MODEL, i * 2654435761u);
+
+	OW_Begin(&ow, &hostUart);
+	DT_SetOneWire(&dt, &ow);
+
+	OW_ResetSearch(&ow);
+	while (n < BUS_DEVICES && OW_SearchNext(&ow, searchOrder[n]))
+		n++;
+	Check(n == BUS_DEVICES && !OW_SearchNext(&ow, searchOrder[0]), "OW_SearchNext finds all 256 devices");
+	OW_ResetSearch(&ow);
+	OW_SearchNext(&ow, searchOrder[0]);
+
+	uint32_t slots = Bus_Slots();
+	CheckRescan(BUS_DEVICES, false, "DT_Rescan, table of 256: full, no overflow");
+	printf("  %lu slots per device\n", (unsigned long) ((Bus_Slots() - slots) / BUS_DEVICES));
+	CheckRescan(BUS_DEVICES - 1, true, "DT_Rescan, table of 255: overflow, first 255 kept");
+	CheckRescan(1, true, "DT_Rescan, table of 1: overflow, first device kept");
+	CheckRescan(sizeof(table) / sizeof(table[0]), false, "DT_Rescan, table of 300: all 256, no overflow");
+
+	DT_SetDeviceTable(&dt, NULL, 0);
+	DT_Rescan(&dt);
+	Check(DT_GetDeviceOverflow(&dt) && TableIsSearchPrefix(ONEWIRE_MAX_DEVICES), "DT_Rescan, built-in table: overflow, first ones kept");
+
+	CheckUpdate(BUS_DEVICES, false, "DT_UpdateDevices, table of 256: full, no overflow");
+	CheckUpdate(BUS_DEVICES - 1, true, "DT_UpdateDevices, table of 255: overflow");
+
+	// nothing of the table may live on the stack
+	StackUsage one = CheckCost(1);
+	StackUsage all = CheckCost(BUS_DEVICES);
+	Check(one.rescan == all.rescan && one.update == all.update && one.updateSame == all.updateSame,
+			"same stack for 1 and 256 devices");
+
+	CheckSensorCount();
+
+	printf("%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
+
+#endif /* ONEWIRE_HOST_CHECK */
@@ -0,0 +1,113 @@
+/*
+ * ResetCheck.c
+ *
+ * Host check of the resets the scratchpad and power supply functions of
+ * DallasTemperature.c put on the bus: one per call, Match ROM or Skip
+ * ROM, and the command must have reached the device.  Compiled only with
+ * ONEWIRE_HOST_CHECK defined, from the directory above:
+ *
+ *   cc -O2 -DONEWIRE_HOST_CHECK -Ihost -I. -o reset_check \
+ *      host/ResetCheck.c host/BusModel.c OneWire.c DallasTemperature.c
+ *   ./reset_check
+ *
+ * Returns 0 if all checks pass.
+ */
+#ifdef ONEWIRE_HOST_CHECK
+
+#include "BusModel.h"
+#include "OneWire.h"
+#include "DallasTemperature.h"
+#include <stdio.h>
+#include <string.h>
+
+static OneWire_HandleTypeDef ow;
+static DallasTemperature_HandleTypeDef dt;
+static unsigned failures;
+static uint32_t resets;
+
+static void Check(bool ok, const char *what)
+{
+	printf("%-60s %s\n", what, ok ? "ok" : "FAILED");
+	if (!ok)
+		failures++;
+}
+
+// resets since the last call
+static uint32_t Resets(void)
+{
+	uint32_t count = Bus_Resets() - resets;
+
+	resets = Bus_Resets();
+	return count;
+}
+
+// every call on device 'index' of a bus of 'devices'
+static void CheckCalls(uint16_t devices, uint16_t index)
+{
+	const uint8_t *address = Bus_Rom(index);
+	ScratchPad scratchPad;
+	bool ok;
+
+	printf("%u device(s), %s:\n", devices, (devices == 1) ? "Skip ROM" : "Match ROM");
+
+	Bus_Clear();
+	for (uint16_t i = 0; i < devices; i++)
+		Bus_AddDevice(DS18B20MODEL, 0x1000 + i * 0x111);
+	Bus_SetParasite(index, true);
+
+	OW_Begin(&ow, &hostUart);
+	DT_SetOneWire(&dt, &ow);
+	DT_Begin(&dt);
+	DT_SetAutoSaveScratchPad(&dt, false);
+	Resets();
+
+	ok = DT_ReadScratchPad(&dt, address, scratchPad);
+	Check(Resets() == 1 && ok && memcmp(scratchPad, Bus_ScratchPad(index), 9) == 0, "  DT_ReadScratchPad: 1 reset, scratchpad read");
+
+	ok = DT_ReadPowerSupply(&dt, address);
+	Check(Resets() == 1 && ok, "  DT_ReadPowerSupply(address): 1 reset, parasite");
+
+	ok = DT_ReadPowerSupply(&dt, NULL);
+	Check(Resets() == 1 && ok, "  DT_ReadPowerSupply(NULL): 1 reset, parasite");
+
+	scratchPad[2] = 30;
+	scratchPad[3] = 10;
+	DT_WriteScratchPad(&dt, address, scratchPad);
+	Check(Resets() == 1 && Bus_ScratchPad(index)[2] == 30 && Bus_Eeprom(index)[0] != 30, "  DT_WriteScratchPad, no auto-save: 1 reset, RAM only");
+
+	ok = DT_SaveScratchPad(&dt, address);
+	Check(Resets() == 1 && ok && Bus_Eeprom(index)[0] == 30 && Bus_Eeprom(index)[1] == 10, "  DT_SaveScratchPad(address): 1 reset, copied");
+
+	scratchPad[2] = 40;
+	DT_WriteScratchPad(&dt, address, scratchPad);
+	Resets();
+	ok = DT_RecallScratchPad(&dt, address);
+	Check(Resets() == 1 && ok && Bus_ScratchPad(index)[2] == 30, "  DT_RecallScratchPad(address): 1 reset, recalled");
+
+	ok = DT_SaveScratchPad(&dt, NULL);
+	Check(Resets() == 1 && ok, "  DT_SaveScratchPad(NULL): 1 reset");
+
+	ok = DT_RecallScratchPad(&dt, NULL);
+	Check(Resets() == 1 && ok, "  DT_RecallScratchPad(NULL): 1 reset");
+
+	DT_SetAutoSaveScratchPad(&dt, true);
+	scratchPad[2] = 50;
+	DT_WriteScratchPad(&dt, address, scratchPad);
+	Check(Resets() == 2 && Bus_Eeprom(index)[0] == 50, "  DT_WriteScratchPad, auto-save: 2 resets, copied");
+}
+
+int main(void)
+{
+	CheckCalls(3, 1);
+	CheckCalls(1, 0);
+
+	// nobody left to answer: nothing was read, so no parasite power
+	Bus_Clear();
+	resets = 0;
+	Check(!DT_ReadPowerSupply(&dt, NULL) && Resets() == 1, "DT_ReadPowerSupply without presence pulse: 1 reset, false");
+
+	printf("%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
+
+#endif /* ONEWIRE_HOST_CHECK */
@@ -0,0 +1,561 @@
+/*
+ * ScenarioCheck.c
+ *
+ * Host scenarios of the bus features of OneWire.c and DallasTemperature.c
+ * on the devices of BusModel.h: the running CRC of the read slots, and
+ * devices unplugged and plugged in under DT_UpdateDevices and the
+ * OW_Verify and scratchpad liveness checks of DT_CheckDevices, the time
+ * sliced DT_UpdateDevicesStep, the family targeted search, the alarm
+ * search with the read pipeline built on it, and the change detection
+ * windows across a new device table.
+ * Compiled only with ONEWIRE_HOST_CHECK defined, from the directory
+ * above:
+ *
+ *   cc -O2 -DONEWIRE_HOST_CHECK -DREQUIRESALARMS=1 -Ihost -I. \
+ *      -o scenario_check host/ScenarioCheck.c host/BusModel.c \
+ *      OneWire.c DallasTemperature.c
+ *   ./scenario_check
+ *
+ * Returns 0 if all checks pass.
+ */
+#ifdef ONEWIRE_HOST_CHECK
+
+#include "BusModel.h"
+#include "OneWire.h"
+#include "DallasTemperature.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_DEVICES		128
+// the longest a call with a reset and 'slots' slots may take on the bus
+// model, a DMA start per slot at most
+#define CALL_US(slots)	(1042 + (slots) * (87 + 6))
+
+static OneWire_HandleTypeDef ow;
+static DallasTemperature_HandleTypeDef dt, sliced;
+static DallasTemperature_DeviceTypeDef table[MAX_DEVICES], slicedTable[MAX_DEVICES];
+static unsigned failures;
+static unsigned added, removed;
+static unsigned alarms;
+static uint8_t alarmed[8][8];
+
+static void Check(bool ok, const char *what)
+{
+	printf("%-60s %s\n", what, ok ? "ok" : "FAILED");
+	if (!ok)
+		failures++;
+}
+
+// a fresh bus of 'devices' of 'family', found and probed by DT_Begin
+static void Start(uint16_t devices, uint8_t family)
+{
+	Bus_Clear();
+	for (uint16_t i = 0; i < devices; i++)
+		Bus_AddDevice(family, 0x3000 + i * 0x2469);
+
+	OW_Begin(&ow, &hostUart);
+	DT_SetOneWire(&dt, &ow);
+	DT_SetDeviceTable(&dt, table, MAX_DEVICES);
+	DT_Begin(&dt);
+}
+
+// index of the table entry of bus device 'index'
+static uint16_t TableIndex(uint16_t index)
+{
+	for (uint16_t i = 0; i < dt.devices; i++)
+	{
+		if (memcmp(dt.device[i].address, Bus_Rom(index), 8) == 0)
+			return i;
+	}
+	return 0xFFFF;
+}
+
+static void Added(const uint8_t *address)
+{
+	(void) address;
+	added++;
+}
+
+static void Removed(const uint8_t *address)
+{
+	(void) address;
+	removed++;
+}
+
+static void Alarm(const uint8_t *address)
+{
+	if (alarms < 8)
+		memcpy(alarmed[alarms], address, 8);
+	alarms++;
+}
+
+// the alarm handler ran for devices 'a', 'b' and 'c' of the bus, once each
+static bool AlarmedAre(uint16_t a, uint16_t b, uint16_t c)
+{
+	const uint16_t expected[3] = { a, b, c };
+
+	if (alarms != 3)
+		return false;
+
+	for (uint16_t i = 0; i < 3; i++)
+	{
+		bool seen = false;
+
+		for (uint16_t j = 0; j < 3; j++)
+			seen |= memcmp(alarmed[j], Bus_Rom(expected[i]), 8) == 0;
+		if (!seen)
+			return false;
+	}
+
+	return true;
+}
+
+// the table holds the devices a plain search finds, in its order
+static bool TableInSearchOrder(void)
+{
+	uint8_t address[8];
+	uint16_t i = 0;
+
+	OW_ResetSearch(&ow);
+	while (OW_SearchNext(&ow, address))
+	{
+		if (i >= dt.devices || memcmp(address, dt.device[i].address, 8) != 0)
+			return false;
+		i++;
+	}
+
+	return i == dt.devices;
+}
+
+// OW_StreamCrc: the CRC8 of the scratchpad checked while it is decoded,
+// in the single and the bulk reads, and the CRC16 residue
+static void StreamCrc(void)
+{
+	static const int16_t temperatures[3] = { 25 * 16 + 3, -10 * 16, 8 };
+	int16_t raw[3];
+	uint8_t status[3];
+	ScratchPad scratchPad;
+	bool ok = true;
+
+	printf("running CRC:\n");
+	Start(3, DS18B20MODEL);
+	for (uint16_t i = 0; i < 3; i++)
+		Bus_SetTemperature(i, temperatures[i]);
+	DT_RequestTemperatures(&dt);
+
+	OW_StreamCrc(&ow, OW_CRC_8, 0);
+	DT_ReadScratchPad(&dt, Bus_Rom(0), scratchPad);
+	Check(OW_StreamCrcOk(&ow) && OW_GetStreamCrc(&ow) == 0 && memcmp(scratchPad, Bus_ScratchPad(0), 9) == 0,
+			"  scratchpad read: residue 0");
+	OW_StreamCrc(&ow, OW_CRC_NONE, 0);
+
+	Check(DT_ReadAllRaw(&dt, raw, status, 3) == 3, "  DT_ReadAllRaw: 3 good");
+	for (uint16_t i = 0; i < 3; i++)
+		ok &= raw[TableIndex(i)] == temperatures[i] * 8 && status[TableIndex(i)] == DT_STATUS_OK;
+	Check(ok, "    the temperatures set");
+
+	// a bit flipped on the way, the CRC byte as sent
+	Bus_CorruptScratchPad(1, true);
+	Check(!DT_IsConnected_ScratchPad(&dt, Bus_Rom(1), scratchPad), "  corrupted: DT_IsConnected_ScratchPad false");
+	Check(DT_IsConnected_ScratchPad(&dt, Bus_Rom(0), scratchPad), "  the others: DT_IsConnected_ScratchPad true");
+
+	DT_ReadAllRaw(&dt, raw, status, 3);
+	Check(status[TableIndex(1)] == DT_STATUS_CRC_FAIL && raw[TableIndex(1)] == DEVICE_DISCONNECTED_RAW
+			&& status[TableIndex(0)] == DT_STATUS_OK && status[TableIndex(2)] == DT_STATUS_OK,
+			"  DT_ReadAllRaw: DT_STATUS_CRC_FAIL for it only");
+	Check(DT_GetTempCByIndex(&dt, TableIndex(1)) == DEVICE_DISCONNECTED_C, "  DT_GetTempCByIndex: DEVICE_DISCONNECTED_C");
+	Bus_CorruptScratchPad(1, false);
+
+	// the bus echoes what is written; after a ROM command nobody knows
+	// the devices stay idle, so the read window gets the bytes themselves
+	uint8_t frame[8] = { 0x00, 0x12, 0x34, 0x56, 0x78, 0x9A };
+	uint8_t echo[7];
+	uint16_t crc16 = ~OW_Crc16(&frame[1], 5, 0);
+
+	frame[6] = (uint8_t) crc16;
+	frame[7] = (uint8_t) (crc16 >> 8);
+	OW_StreamCrc(&ow, OW_CRC_16, 0);
+	OW_Send(&ow, OW_SEND_RESET, frame, 8, echo, 7, 1);
+	Check(OW_StreamCrcOk(&ow) && memcmp(echo, &frame[1], 7) == 0, "  CRC16 with the inverted CRC: residue ok");
+
+	frame[3] ^= 0x01;
+	OW_StreamCrc(&ow, OW_CRC_16, 0);
+	OW_Send(&ow, OW_SEND_RESET, frame, 8, echo, 7, 1);
+	Check(!OW_StreamCrcOk(&ow), "  CRC16 of a changed frame: residue wrong");
+	OW_StreamCrc(&ow, OW_CRC_NONE, 0);
+}
+
+// hot-plug: DT_UpdateDevices merges what the search finds into the
+// table, DT_CheckDevices drops the devices that stopped answering
+static void HotPlug(void)
+{
+	uint32_t slots, resets;
+	uint16_t changes;
+	bool ok = true;
+
+	printf("hot-plug:\n");
+	Start(6, DS18B20MODEL);
+	DT_SetDeviceHandlers(&dt, Added, Removed);
+	DT_StartConversion(&dt);
+	while (DT_IsConverting(&dt))
+	{
+		HAL_Delay(5);
+		DT_Service(&dt);
+	}
+
+	resets = Bus_Resets();
+	changes = DT_UpdateDevices(&dt);
+	Check(changes == 0 && Bus_Resets() - resets == 6 && TableInSearchOrder(), "  DT_UpdateDevices, nothing changed: 0, a reset per device");
+
+	// 2 out, 2 new in, one of them no sensor
+	Bus_SetPresent(1, false);
+	Bus_SetPresent(4, false);
+	Bus_AddDevice(DS18B20MODEL, 0x7777);
+	Bus_AddDevice(0x29, 0x0101);
+	added = removed = 0;
+	changes = DT_UpdateDevices(&dt);
+	Check(changes == 4 && added == 2 && removed == 2 && dt.devices == 6 && DT_GetDS18Count(&dt) == 5 && TableInSearchOrder(),
+			"  2 unplugged, 2 plugged in: 4 changes, handlers ran");
+	for (uint16_t i = 0; i < dt.devices; i++)
+	{
+		bool old = memcmp(dt.device[i].address, Bus_Rom(6), 8) != 0 && memcmp(dt.device[i].address, Bus_Rom(7), 8) != 0;
+
+		ok &= (dt.device[i].status == DT_STATUS_OK) == old;
+	}
+	Check(ok, "    the devices kept keep their samples, new ones have none");
+
+	Check(OW_Verify(&ow, Bus_Rom(0)) && !OW_Verify(&ow, Bus_Rom(1)), "  OW_Verify: true for a device there, false for one gone");
+
+	// OW_Verify follows the ROM code, any family answers
+	Bus_SetPresent(0, false);
+	removed = 0;
+	slots = Bus_Slots();
+	changes = DT_CheckDevices(&dt, false);
+	printf("  DT_CheckDevices(OW_Verify): %lu slots for %u devices\n", (unsigned long) (Bus_Slots() - slots), dt.devices + changes);
+	Check(changes == 1 && removed == 1 && dt.devices == 5 && TableInSearchOrder(), "  1 unplugged, DT_CheckDevices(false): 1 removed");
+
+	Bus_SetPresent(2, false);
+	changes = DT_CheckDevices(&dt, true);
+	Check(changes == 1 && dt.devices == 4 && DT_GetDS18Count(&dt) == 3 && TableInSearchOrder(), "  1 unplugged, DT_CheckDevices(true): 1 removed");
+	Check(DT_CheckDevices(&dt, false) == 0 && DT_CheckDevices(&dt, true) == 0, "  nothing changed: DT_CheckDevices 0");
+
+	for (uint16_t i = 0; i < 8; i++)
+		Bus_SetPresent(i, false);
+	changes = DT_UpdateDevices(&dt);
+	Check(changes == 4 && dt.devices == 0 && DT_GetDS18Count(&dt) == 0, "  all unplugged: DT_UpdateDevices empties the table");
+
+	// a single device is read with Skip ROM, the one swapped in for it
+	// would answer that
+	Bus_SetPresent(3, true);
+	DT_UpdateDevices(&dt);
+	Bus_SetPresent(3, false);
+	Bus_SetPresent(5, true);
+	Check(dt.devices == 1 && DT_CheckDevices(&dt, true) == 1 && dt.devices == 0, "  single device swapped: DT_CheckDevices(true) drops it");
+	Check(DT_UpdateDevices(&dt) == 1 && dt.devices == 1 && TableInSearchOrder(), "    and DT_UpdateDevices finds the new one");
+
+	DT_SetDeviceHandlers(&dt, NO_DEVICE_HANDLER, NO_DEVICE_HANDLER);
+}
+
+// DT_UpdateDevicesStep from an empty table: the table of DT_Begin,
+// with every call bounded by its triplets and the probe of one device
+static void TimeSliced(void)
+{
+	static const uint8_t slices[3] = { 1, 8, 64 };
+	uint64_t start, worst;
+	char line[80];
+
+	printf("time sliced update, 100 devices:\n");
+	Bus_Clear();
+	for (uint32_t i = 0; i < 100; i++)
+		Bus_AddDevice(DS18B20MODEL, i * 2654435761u);
+
+	OW_Begin(&ow, &hostUart);
+	DT_SetOneWire(&dt, &ow);
+	DT_SetDeviceTable(&dt, table, MAX_DEVICES);
+	start = Bus_Micros();
+	DT_Begin(&dt);
+	uint64_t begin = Bus_Micros() - start;
+	printf("  DT_Begin: %lu ms\n", (unsigned long) (begin / 1000));
+
+	// the probe of a device: Read Power Supply and a scratchpad read
+	DT_InvalidateConfig(&dt, Bus_Rom(0));
+	start = Bus_Micros();
+	DT_ReadPowerSupply(&dt, Bus_Rom(0));
+	DT_GetResolution(&dt, Bus_Rom(0));
+	uint64_t probe = Bus_Micros() - start;
+
+	for (uint8_t k = 0; k < 3; k++)
+	{
+		uint16_t changes = 0;
+		uint32_t calls = 0;
+		bool done, same;
+
+		DT_SetOneWire(&sliced, &ow);
+		DT_SetDeviceTable(&sliced, slicedTable, MAX_DEVICES);
+		worst = 0;
+		start = Bus_Micros();
+		do
+		{
+			uint64_t call = Bus_Micros();
+
+			done = DT_UpdateDevicesStep(&sliced, slices[k], &changes);
+			calls++;
+			if (Bus_Micros() - call > worst)
+				worst = Bus_Micros() - call;
+		} while (!done);
+
+		same = (sliced.devices == dt.devices && DT_GetDS18Count(&sliced) == 100);
+		for (uint16_t i = 0; same && i < dt.devices; i++)
+			same = memcmp(slicedTable[i].address, table[i].address, 8) == 0 && slicedTable[i].resolution == table[i].resolution;
+
+		printf("  %2u triplets per call: %5lu calls, worst %5lu us, %lu ms in all\n", slices[k], (unsigned long) calls,
+				(unsigned long) worst, (unsigned long) ((Bus_Micros() - start) / 1000));
+		snprintf(line, sizeof(line), "  %u triplets: the table of DT_Begin, 100 changes", slices[k]);
+		Check(same && changes == 100, line);
+		snprintf(line, sizeof(line), "  %u triplets: within 1%% of the bus time of DT_Begin", slices[k]);
+		Check(Bus_Micros() - start <= begin + begin / 100, line);
+		// a reset, Search ROM and the triplets, plus a probe
+		snprintf(line, sizeof(line), "  %u triplets: worst call <= %lu us", slices[k],
+				(unsigned long) (CALL_US(8 + slices[k] * 3) + probe));
+		Check(worst <= CALL_US(8 + slices[k] * 3) + probe, line);
+	}
+
+	// no probe: only the triplets of a call
+	uint8_t address[8];
+	uint8_t result;
+	uint16_t found = 0;
+
+	worst = 0;
+	OW_ResetSearch(&ow);
+	do
+	{
+		uint64_t call = Bus_Micros();
+
+		result = OW_SearchStep(&ow, address, 8);
+		if (Bus_Micros() - call > worst)
+			worst = Bus_Micros() - call;
+		if (result == OW_OK)
+			found++;
+	} while (result != OW_NO_DEVICE);
+	printf("  OW_SearchStep(8): worst %lu us\n", (unsigned long) worst);
+	Check(found == 100 && worst <= CALL_US(8 + 8 * 3), "  OW_SearchStep(8): 100 found, worst call a reset and 32 slots");
+}
+
+// the sensors of the table, in its order, are those of 'sensors'
+static bool SameSensors(const DallasTemperature_HandleTypeDef *all, const DallasTemperature_HandleTypeDef *sensors)
+{
+	uint16_t j = 0;
+
+	for (uint16_t i = 0; i < all->devices; i++)
+	{
+		if (!DT_ValidFamily(all->device[i].address))
+			continue;
+		if (j >= sensors->devices || memcmp(all->device[i].address, sensors->device[j].address, 8) != 0)
+			return false;
+		j++;
+	}
+
+	return j == sensors->devices;
+}
+
+// OW_TargetSearch walks only the branch of its family; DT_SetSensorSearch
+// finds the sensors among other devices with one such search per family
+static void FamilySearch(void)
+{
+	// DS2408 and DS2431 between the sensors
+	static const uint8_t families[9] = { 0x29, 0x2D, 0x29, 0x2D, DS18B20MODEL, DS18S20MODEL, DS1822MODEL, DS1825MODEL, DS28EA00MODEL };
+	uint8_t address[8];
+	uint32_t slots, resets, allSlots;
+	uint16_t found, changes;
+	bool ok = true;
+
+	printf("family search, 60 devices, 28 no sensors:\n");
+	Bus_Clear();
+	for (uint32_t i = 0; i < 60; i++)
+		Bus_AddDevice(families[i % 9], i * 2654435761u);
+
+	OW_Begin(&ow, &hostUart);
+	DT_SetOneWire(&dt, &ow);
+	DT_SetDeviceTable(&dt, table, MAX_DEVICES);
+	slots = Bus_Slots();
+	DT_Rescan(&dt);
+	allSlots = Bus_Slots() - slots;
+
+	DT_SetOneWire(&sliced, &ow);
+	DT_SetDeviceTable(&sliced, slicedTable, MAX_DEVICES);
+	DT_SetSensorSearch(&sliced, true);
+	slots = Bus_Slots();
+	resets = Bus_Resets();
+	DT_Rescan(&sliced);
+	printf("  DT_Rescan: %lu slots for all, %lu slots and %lu resets for the sensors\n", (unsigned long) allSlots,
+			(unsigned long) (Bus_Slots() - slots), (unsigned long) (Bus_Resets() - resets));
+	Check(dt.devices == 60 && sliced.devices == 32 && SameSensors(&dt, &sliced), "  sensor search: the 32 sensors of the full search, same order");
+	Check(Bus_Slots() - slots < allSlots * 6 / 10, "    in less than 60% of the slots");
+
+	OW_TargetSearch(&ow, 0x26);
+	slots = Bus_Slots();
+	Check(!OW_SearchNext(&ow, address) && ow.LastDeviceFlag && Bus_Slots() - slots <= 8 + 8 * 3,
+			"  absent family: nothing found, clean end within 8 triplets");
+
+	OW_TargetSearch(&ow, DS18B20MODEL);
+	found = 0;
+	while (OW_SearchNext(&ow, address))
+	{
+		ok &= address[0] == DS18B20MODEL;
+		found++;
+	}
+	Check(ok && found == 7 && ow.LastDeviceFlag, "  OW_TargetSearch(DS18B20): the 7 of them only");
+
+	OW_ResetSearch(&ow);
+	found = 0;
+	while (OW_SearchNext(&ow, address))
+		found++;
+	Check(found == 60, "  OW_ResetSearch: all 60 again");
+
+	// a DS18S20 out, a DS1822 and a DS2431 in
+	Check(DT_UpdateDevices(&sliced) == 0, "  DT_UpdateDevices, sensor search, nothing changed: 0");
+	Bus_SetPresent(5, false);
+	Bus_AddDevice(DS1822MODEL, 0xABCDEF);
+	Bus_AddDevice(0x2D, 0x1234);
+	changes = 0;
+	while (!DT_UpdateDevicesStep(&sliced, 8, &changes))
+		;
+	DT_Rescan(&dt);
+	Check(changes == 2 && sliced.devices == 32 && SameSensors(&dt, &sliced), "  sliced update, sensor search: 2 changes, same as a full search");
+
+	// a full table switched to sensor search drops the others
+	DT_SetSensorSearch(&dt, true);
+	Check(DT_UpdateDevices(&dt) == 29 && dt.devices == 32 && DT_GetDS18Count(&dt) == 32, "  switched to sensor search: the 29 others dropped");
+}
+
+// Alarm Search finds only the devices out of their TH/TL window, and
+// DT_ConvertAndProcessAlarms reads only those
+static void AlarmSearch(void)
+{
+	uint8_t address[8];
+	uint32_t slots, readAllSlots;
+	uint16_t n;
+	bool ok = true;
+
+	printf("alarm search, 100 sensors, TH 30 TL 10:\n");
+	Start(100, DS18B20MODEL);
+	DT_ConfigureAll(&dt, 30, 10, 12, true);
+	DT_SetAlarmHandler(&dt, Alarm);
+	for (uint16_t i = 0; i < 100; i++)
+		Bus_SetTemperature(i, (20 + i % 5) * 16);
+
+	slots = Bus_Slots();
+	DT_RequestTemperatures(&dt);
+	DT_ReadAllRaw(&dt, (int16_t [100]) { 0 }, NULL, 100);
+	readAllSlots = Bus_Slots() - slots;
+	Check(!DT_HasAlarm(&dt), "  all within TH/TL: DT_HasAlarm false");
+
+	// above, below and at TH
+	Bus_SetTemperature(7, 40 * 16);
+	Bus_SetTemperature(42, -5 * 16);
+	Bus_SetTemperature(93, 30 * 16);
+	alarms = 0;
+	slots = Bus_Slots();
+	n = DT_ConvertAndProcessAlarms(&dt);
+	printf("  DT_ConvertAndProcessAlarms: %lu slots, DT_RequestTemperatures + DT_ReadAllRaw: %lu\n",
+			(unsigned long) (Bus_Slots() - slots), (unsigned long) readAllSlots);
+	Check(n == 3 && AlarmedAre(7, 42, 93), "  DT_ConvertAndProcessAlarms: the 3 alarmed, handler once each");
+	Check(Bus_Slots() - slots < readAllSlots / 4, "    in less than a quarter of the slots of reading all");
+
+	for (uint16_t i = 0; i < 100; i++)
+	{
+		uint16_t index = TableIndex(i);
+		int16_t raw = (int16_t) ((Bus_ScratchPad(i)[1] << 8) | Bus_ScratchPad(i)[0]) * 8;
+
+		if (i == 7 || i == 42 || i == 93)
+			ok &= DT_GetSampleStatus(&dt, index) == DT_STATUS_OK && DT_GetSampleRaw(&dt, index) == raw;
+		else
+			ok &= DT_GetSampleStatus(&dt, index) != DT_STATUS_OK;
+	}
+	Check(ok, "    samples of the alarmed devices stored, no others read");
+
+	Check(DT_HasAlarm(&dt), "  DT_HasAlarm true");
+	alarms = 0;
+	DT_ProcessAlarms(&dt);
+	Check(AlarmedAre(7, 42, 93), "  DT_ProcessAlarms: handler for the 3");
+	Check(!DT_AlarmSearch(&dt, address), "    and the alarm search is at its end");
+
+	for (uint16_t i = 0; i < 100; i++)
+		Bus_SetTemperature(i, 20 * 16);
+	alarms = 0;
+	n = DT_ConvertAndProcessAlarms(&dt);
+	Check(n == 0 && alarms == 0 && !DT_HasAlarm(&dt), "  back within TH/TL: no alarms, DT_HasAlarm false");
+
+	DT_SetAlarmHandler(&dt, NO_ALARM_HANDLER);
+}
+
+// the change detection windows of DT_ConvertAndReadChanged in the RAM of
+// 3 devices at 25 C, TH 30 and TL 10 in their EEPROM
+static void SetWindows(void)
+{
+	bool ok = true;
+
+	DT_SetChangeDetection(&dt, 2);
+	DT_ConvertAndReadChanged(&dt);
+	for (uint16_t i = 0; i < 3; i++)
+		ok &= Bus_ScratchPad(i)[2] == 27 && Bus_ScratchPad(i)[3] == 23;
+	Check(ok, "  DT_ConvertAndReadChanged: windows 23..27 in RAM");
+}
+
+// the devices hold TH 30 and TL 10 again, and keep them after a Copy
+// Scratchpad
+static bool WindowsRestored(void)
+{
+	bool ok = true;
+
+	for (uint16_t i = 0; i < 3; i++)
+		ok &= Bus_ScratchPad(i)[2] == 30 && Bus_ScratchPad(i)[3] == 10;
+
+	DT_SaveScratchPad(&dt, NULL);
+	for (uint16_t i = 0; i < 3; i++)
+	{
+		ok &= Bus_Eeprom(i)[0] == 30 && Bus_Eeprom(i)[1] == 10;
+		ok &= DT_GetHighAlarmTemp(&dt, Bus_Rom(i)) == 30 && DT_GetLowAlarmTemp(&dt, Bus_Rom(i)) == 10;
+	}
+
+	return ok;
+}
+
+// a table started over must not take the windows the devices still hold
+// for their TH/TL
+static void ChangeWindows(void)
+{
+	printf("change detection windows, 3 sensors:\n");
+	Start(3, DS18B20MODEL);
+	DT_ConfigureAll(&dt, 30, 10, 12, true);
+
+	SetWindows();
+	DT_Rescan(&dt);
+	Check(WindowsRestored(), "  DT_Rescan, DT_SaveScratchPad: TH/TL back, EEPROM kept");
+
+	SetWindows();
+	DT_Begin(&dt);
+	Check(WindowsRestored(), "  DT_Begin, DT_SaveScratchPad: TH/TL back, EEPROM kept");
+
+	SetWindows();
+	DT_SetDeviceTable(&dt, table, MAX_DEVICES);
+	DT_UpdateDevices(&dt);
+	Check(WindowsRestored(), "  DT_SetDeviceTable, DT_UpdateDevices, DT_SaveScratchPad: same");
+
+	DT_SetChangeDetection(&dt, 0);
+}
+
+int main(void)
+{
+	StreamCrc();
+	HotPlug();
+	TimeSliced();
+	FamilySearch();
+	AlarmSearch();
+	ChangeWindows();
+
+	printf("%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
+
+#endif /* ONEWIRE_HOST_CHECK */
@@ -0,0 +1,114 @@
+/*
+ * TransferCheck.c
+ *
+ * Host benchmark of the transfers of one Match ROM scratchpad read, the
+ * 19 byte query DT_ReadScratchPad sends: DMA starts, slots and the time
+ * the bus idles between them, with or without ONEWIRE_SINGLE_DMA.
+ * Compiled only with ONEWIRE_HOST_CHECK defined; build and run it once
+ * per mode from the directory above:
+ *
+ *   for m in 1 0; do
+ *     cc -O2 -DONEWIRE_HOST_CHECK -DONEWIRE_STATS=1 -DONEWIRE_SINGLE_DMA=$m \
+ *        -Ihost -I. -o transfer_check host/TransferCheck.c host/BusModel.c \
+ *        OneWire.c DallasTemperature.c && ./transfer_check
+ *   done
+ *
+ * Idle time is what the DMA set-up of the model (BusModel.c) costs, so
+ * it compares the modes rather than predicting a part.  Returns 0 if
+ * every read got the scratchpad and the transfers add up.
+ */
+#ifdef ONEWIRE_HOST_CHECK
+
+#include "BusModel.h"
+#include "OneWire.h"
+#include "DallasTemperature.h"
+#include <stdio.h>
+#include <string.h>
+
+#define READS			100
+// Match ROM, Read Scratchpad and 9 read slots, a byte is 8 slots
+#define QUERY_SLOTS		(19 * 8)
+
+static OneWire_HandleTypeDef ow;
+static DallasTemperature_HandleTypeDef dt;
+static unsigned failures;
+
+static void Check(bool ok, const char *what)
+{
+	printf("%-52s %s\n", what, ok ? "ok" : "FAILED");
+	if (!ok)
+		failures++;
+}
+
+// DMA starts a read takes: the reset, then the query in bursts
+static uint32_t ExpectedDmaStarts(uint16_t frameBurst)
+{
+#if ONEWIRE_SINGLE_DMA
+	(void) frameBurst;
+	return 1 + 1;
+#else
+	// the prepared Match ROM frame goes in bursts of the slot buffer,
+	// the command bytes one at a time
+	return 1 + (frameBurst ? 72 / ONEWIRE_SLOT_BUF_SIZE + 10 : 19);
+#endif
+}
+
+static void Report(const char *what, uint16_t frameBurst, uint32_t dmaStarts, uint32_t slots, bool good)
+{
+	printf("%s, ONEWIRE_SINGLE_DMA=%d:\n", what, ONEWIRE_SINGLE_DMA);
+	printf("  %lu DMA starts, %lu slots, %lu resets per read\n",
+			(unsigned long) (dmaStarts / READS), (unsigned long) (slots / READS),
+			(unsigned long) (ow.stats.resets / READS));
+	printf("  %lu us on the bus, %lu us of it idle, %lu us per reset\n",
+			(unsigned long) (ow.stats.busyTicks / (SystemCoreClock / 1000000) / READS),
+			(unsigned long) (OW_GetIdleMicros(&ow) / READS),
+			(unsigned long) OW_GetResetMicros(&ow));
+
+	Check(good, "  every read got the scratchpad");
+	Check(dmaStarts == READS * ExpectedDmaStarts(frameBurst) && ow.stats.dmaStarts == dmaStarts, "  DMA starts as expected, statistics agree");
+	Check(slots == READS * QUERY_SLOTS && ow.stats.slots == slots, "  152 slots per read");
+}
+
+int main(void)
+{
+	uint8_t query[19] = { 0x55, 0, 0, 0, 0, 0, 0, 0, 0, 0xBE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+	uint8_t scratchPad[9];
+	bool good = true;
+
+	Bus_Clear();
+	Bus_AddDevice(DS18B20MODEL, 0x00C0FFEE);
+	Bus_AddDevice(DS18B20MODEL, 0x00BEEF00);
+
+	OW_Begin(&ow, &hostUart);
+	DT_SetOneWire(&dt, &ow);
+	DT_Begin(&dt);
+
+	// OW_Send encodes the whole query
+	memcpy(&query[1], Bus_Rom(0), 8);
+	OW_ResetStats(&ow);
+	uint32_t dmaStarts = Bus_DmaStarts();
+	uint32_t slots = Bus_Slots();
+	for (int i = 0; i < READS; i++)
+	{
+		good &= (OW_Send(&ow, OW_SEND_RESET, query, 19, scratchPad, 9, 10) == OW_OK);
+		good &= (memcmp(scratchPad, Bus_ScratchPad(0), 9) == 0);
+	}
+	Report("OW_Send", 0, Bus_DmaStarts() - dmaStarts, Bus_Slots() - slots, good);
+
+	// DT_ReadScratchPad sends the prepared Match ROM frame of the table
+	good = true;
+	OW_ResetStats(&ow);
+	dmaStarts = Bus_DmaStarts();
+	slots = Bus_Slots();
+	for (int i = 0; i < READS; i++)
+	{
+		good &= DT_ReadScratchPad(&dt, Bus_Rom(1), scratchPad);
+		good &= (memcmp(scratchPad, Bus_ScratchPad(1), 9) == 0);
+	}
+	Report("DT_ReadScratchPad", DT_MATCH_ROM_FRAMES, Bus_DmaStarts() - dmaStarts, Bus_Slots() - slots, good);
+
+	printf("%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
+
+#endif /* ONEWIRE_HOST_CHECK */
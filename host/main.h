@@ -0,0 +1,172 @@
+/*
+ * main.h
+ *
+ * The part of the STM32 HAL that OneWire.c and DallasTemperature.c use,
+ * for the host checks in this directory.  BusModel.c implements it with
+ * a model of devices on the bus.  Not for firmware builds: keep this
+ * directory off the include path of the target.
+ */
+
+#ifndef HOST_MAIN_H_
+#define HOST_MAIN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum
+{
+	HAL_OK = 0,
+	HAL_ERROR,
+	HAL_BUSY,
+	HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+	HAL_UART_STATE_RESET = 0x00,
+	HAL_UART_STATE_READY = 0x20,
+	HAL_UART_STATE_BUSY_RX = 0x22,
+	HAL_UART_STATE_TIMEOUT = 0xA0
+} HAL_UART_StateTypeDef;
+
+typedef struct
+{
+	volatile uint32_t BRR;
+	volatile uint32_t CR1;
+} USART_TypeDef;
+
+typedef struct
+{
+	uint32_t BaudRate;
+	uint32_t WordLength;
+	uint32_t StopBits;
+	uint32_t Parity;
+	uint32_t Mode;
+	uint32_t HwFlowCtl;
+	uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef struct
+{
+	USART_TypeDef *Instance;
+	UART_InitTypeDef Init;
+	volatile HAL_UART_StateTypeDef gState;
+	// echo buffer of the DMA receive armed before the transmit
+	uint8_t *rxBuf;
+	uint16_t rxLen;
+} UART_HandleTypeDef;
+
+#define UART_WORDLENGTH_8B		0
+#define UART_STOPBITS_1			0
+#define UART_PARITY_NONE		0
+#define UART_MODE_TX_RX			0x0C
+#define UART_HWCONTROL_NONE		0
+#define UART_OVERSAMPLING_16	0
+
+#define USART_CR1_UE			(1u << 13)
+#define __HAL_UART_ENABLE(h)	((h)->Instance->CR1 |= USART_CR1_UE)
+#define __HAL_UART_DISABLE(h)	((h)->Instance->CR1 &= ~USART_CR1_UE)
+#define __NOP()					do {} while (0)
+#define HAL_MAX_DELAY			0xFFFFFFFFu
+
+HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart);
+HAL_UART_StateTypeDef HAL_UART_GetState(UART_HandleTypeDef *huart);
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+// the cycle counter ONEWIRE_STATS times transfers with, running at
+// SystemCoreClock on the clock of the bus model
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk		(1u << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk	(1u << 24)
+
+extern DWT_Type hostDwt;
+extern CoreDebug_Type hostCoreDebug;
+extern uint32_t SystemCoreClock;
+#define DWT						(&hostDwt)
+#define CoreDebug				(&hostCoreDebug)
+
+// the CRC unit with programmable polynomial OW_HwCrc8/OW_HwCrc16 drive,
+// modelled by OneWire_CrcCheck.c: every access goes through
+// HostCrc_Unit(), which acts on a RESET written to CR, and the byte
+// writes to DR through OW_CRC_DR_WRITE8
+typedef struct
+{
+	volatile uint32_t DR;
+	volatile uint32_t IDR;
+	volatile uint32_t CR;
+	uint32_t RESERVED;
+	volatile uint32_t INIT;
+	volatile uint32_t POL;
+} CRC_TypeDef;
+
+#define CRC_CR_RESET			(1u << 0)
+#define CRC_CR_POLYSIZE_0		(1u << 3)
+#define CRC_CR_POLYSIZE_1		(1u << 4)
+#define CRC_CR_POLYSIZE			(CRC_CR_POLYSIZE_0 | CRC_CR_POLYSIZE_1)
+#define CRC_CR_REV_IN_0			(1u << 5)
+#define CRC_CR_REV_IN_1			(1u << 6)
+#define CRC_CR_REV_IN			(CRC_CR_REV_IN_0 | CRC_CR_REV_IN_1)
+#define CRC_CR_REV_OUT			(1u << 7)
+#define __IO					volatile
+
+CRC_TypeDef *HostCrc_Unit(void);
+#define CRC						(HostCrc_Unit())
+
+void HostCrc_Write8(uint8_t data);
+#define OW_CRC_DR_WRITE8(b)		HostCrc_Write8(b)
+
+static inline uint32_t __RBIT(uint32_t value)
+{
+	uint32_t result = 0;
+
+	for (int i = 0; i < 32; i++, value >>= 1)
+		result = (result << 1) | (value & 1);
+	return result;
+}
+
+typedef struct
+{
+	uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum
+{
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+	uint32_t Pin;
+	uint32_t Mode;
+	uint32_t Pull;
+	uint32_t Speed;
+} GPIO_InitTypeDef;
+
+#define GPIO_PIN_10				(1u << 10)
+#define GPIO_MODE_OUTPUT_PP		1
+#define GPIO_PULLUP				1
+#define GPIO_SPEED_FREQ_MEDIUM	1
+
+extern GPIO_TypeDef hostGpioC;
+#define GPIOC					(&hostGpioC)
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin, GPIO_PinState PinState);
+
+#endif /* HOST_MAIN_H_ */